@@ -2,24 +2,133 @@
 * Filename:         ball.c
 * Description:      Ball object used in pong on Keil MCB1700 board
 * Author(s):        George Cowan, Alexander Rathke
-* Date Modified:    Nov. 13, 2017
+* Date Modified:    Oct. 16, 2026
 *----------------------------------------------------------------------------*/
-#include <lpc17xx.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 #include "GLCD.h"
 #include "point.h"
 #include "utils.h"
+#include "sprite.h"
 #include "ball.h"
+#include "prof.h"
 
 /*----------------------------------------------------------------------------
  *      Ball Constants
  *---------------------------------------------------------------------------*/
 
 const uint16_t BALL_RADIUS = 6;
-const uint32_t BITMAP_DIM  = ((BALL_RADIUS)*2) + 1;
+
+/*
+circle masks are built by the compiler and stored in flash, one row per
+line of the bounding box with bit (dx + r) set if pixel is lit
+pixel is lit if dx^2 + dy^2 <= r^2 + 1, this is the same fill
+Bresenham's circle algorithm gives for radius 2, 3, 4 and 6
+*/
+#define CIRCLE_MIN_RADIUS       2
+#define CIRCLE_MAX_RADIUS       7
+
+#define MASK_BIT(r, dy, dx)     ((((dx) >= -(r)) && ((dx) <= (r)) && \
+                                  (((dx)*(dx)) + ((dy)*(dy)) <= ((r)*(r)) + 1)) ? \
+                                  (1u << (((dx) + (r)) & 0xF)) : 0u)
+#define MASK_ROW(r, dy)         ((uint16_t) ( \
+                                  MASK_BIT(r, dy, -7) | MASK_BIT(r, dy, -6) | MASK_BIT(r, dy, -5) | MASK_BIT(r, dy, -4) | MASK_BIT(r, dy, -3) | \
+                                  MASK_BIT(r, dy, -2) | MASK_BIT(r, dy, -1) | MASK_BIT(r, dy,  0) | MASK_BIT(r, dy,  1) | MASK_BIT(r, dy,  2) | \
+                                  MASK_BIT(r, dy,  3) | MASK_BIT(r, dy,  4) | MASK_BIT(r, dy,  5) | MASK_BIT(r, dy,  6) | MASK_BIT(r, dy,  7)))
+
+static const uint16_t CIRCLE_MASK_2[5] = {
+    MASK_ROW(2, -2), MASK_ROW(2, -1), MASK_ROW(2,  0), MASK_ROW(2,  1),
+    MASK_ROW(2,  2)
+};
+
+static const uint16_t CIRCLE_MASK_3[7] = {
+    MASK_ROW(3, -3), MASK_ROW(3, -2), MASK_ROW(3, -1), MASK_ROW(3,  0),
+    MASK_ROW(3,  1), MASK_ROW(3,  2), MASK_ROW(3,  3)
+};
+
+static const uint16_t CIRCLE_MASK_4[9] = {
+    MASK_ROW(4, -4), MASK_ROW(4, -3), MASK_ROW(4, -2), MASK_ROW(4, -1),
+    MASK_ROW(4,  0), MASK_ROW(4,  1), MASK_ROW(4,  2), MASK_ROW(4,  3),
+    MASK_ROW(4,  4)
+};
+
+static const uint16_t CIRCLE_MASK_5[11] = {
+    MASK_ROW(5, -5), MASK_ROW(5, -4), MASK_ROW(5, -3), MASK_ROW(5, -2),
+    MASK_ROW(5, -1), MASK_ROW(5,  0), MASK_ROW(5,  1), MASK_ROW(5,  2),
+    MASK_ROW(5,  3), MASK_ROW(5,  4), MASK_ROW(5,  5)
+};
+
+static const uint16_t CIRCLE_MASK_6[13] = {
+    MASK_ROW(6, -6), MASK_ROW(6, -5), MASK_ROW(6, -4), MASK_ROW(6, -3),
+    MASK_ROW(6, -2), MASK_ROW(6, -1), MASK_ROW(6,  0), MASK_ROW(6,  1),
+    MASK_ROW(6,  2), MASK_ROW(6,  3), MASK_ROW(6,  4), MASK_ROW(6,  5),
+    MASK_ROW(6,  6)
+};
+
+static const uint16_t CIRCLE_MASK_7[15] = {
+    MASK_ROW(7, -7), MASK_ROW(7, -6), MASK_ROW(7, -5), MASK_ROW(7, -4),
+    MASK_ROW(7, -3), MASK_ROW(7, -2), MASK_ROW(7, -1), MASK_ROW(7,  0),
+    MASK_ROW(7,  1), MASK_ROW(7,  2), MASK_ROW(7,  3), MASK_ROW(7,  4),
+    MASK_ROW(7,  5), MASK_ROW(7,  6), MASK_ROW(7,  7)
+};
+
+static const uint16_t * const CIRCLE_MASKS[CIRCLE_MAX_RADIUS + 1] = {
+    NULL, NULL, CIRCLE_MASK_2, CIRCLE_MASK_3,
+    CIRCLE_MASK_4, CIRCLE_MASK_5, CIRCLE_MASK_6, CIRCLE_MASK_7
+};
+
+/*
+each row of a circle is one run of lit pixels, same fill as the masks,
+stored as (start, length) so drawing touches only lit pixels
+*/
+#define SPAN_BIT(r, dy, dx)     ((((dx) <= (r)) && (((dx)*(dx)) + ((dy)*(dy)) <= ((r)*(r)) + 1)) ? 1 : 0)
+#define SPAN_HALF(r, dy)        ( \
+                                  SPAN_BIT(r, dy, 1) + SPAN_BIT(r, dy, 2) + SPAN_BIT(r, dy, 3) + SPAN_BIT(r, dy, 4) + \
+                                  SPAN_BIT(r, dy, 5) + SPAN_BIT(r, dy, 6) + SPAN_BIT(r, dy, 7))
+#define SPAN(r, dy)             { (r) - SPAN_HALF(r, dy), (2 * SPAN_HALF(r, dy)) + 1 }
+
+static const Span CIRCLE_SPANS_2[5] = {
+    SPAN(2, -2), SPAN(2, -1), SPAN(2,  0), SPAN(2,  1),
+    SPAN(2,  2)
+};
+
+static const Span CIRCLE_SPANS_3[7] = {
+    SPAN(3, -3), SPAN(3, -2), SPAN(3, -1), SPAN(3,  0),
+    SPAN(3,  1), SPAN(3,  2), SPAN(3,  3)
+};
+
+static const Span CIRCLE_SPANS_4[9] = {
+    SPAN(4, -4), SPAN(4, -3), SPAN(4, -2), SPAN(4, -1),
+    SPAN(4,  0), SPAN(4,  1), SPAN(4,  2), SPAN(4,  3),
+    SPAN(4,  4)
+};
+
+static const Span CIRCLE_SPANS_5[11] = {
+    SPAN(5, -5), SPAN(5, -4), SPAN(5, -3), SPAN(5, -2),
+    SPAN(5, -1), SPAN(5,  0), SPAN(5,  1), SPAN(5,  2),
+    SPAN(5,  3), SPAN(5,  4), SPAN(5,  5)
+};
+
+static const Span CIRCLE_SPANS_6[13] = {
+    SPAN(6, -6), SPAN(6, -5), SPAN(6, -4), SPAN(6, -3),
+    SPAN(6, -2), SPAN(6, -1), SPAN(6,  0), SPAN(6,  1),
+    SPAN(6,  2), SPAN(6,  3), SPAN(6,  4), SPAN(6,  5),
+    SPAN(6,  6)
+};
+
+static const Span CIRCLE_SPANS_7[15] = {
+    SPAN(7, -7), SPAN(7, -6), SPAN(7, -5), SPAN(7, -4),
+    SPAN(7, -3), SPAN(7, -2), SPAN(7, -1), SPAN(7,  0),
+    SPAN(7,  1), SPAN(7,  2), SPAN(7,  3), SPAN(7,  4),
+    SPAN(7,  5), SPAN(7,  6), SPAN(7,  7)
+};
+
+static const Span * const CIRCLE_SPANS[CIRCLE_MAX_RADIUS + 1] = {
+    NULL, NULL, CIRCLE_SPANS_2, CIRCLE_SPANS_3,
+    CIRCLE_SPANS_4, CIRCLE_SPANS_5, CIRCLE_SPANS_6, CIRCLE_SPANS_7
+};
 
 /*----------------------------------------------------------------------------
  *      Function Definitions
@@ -38,6 +147,7 @@ Ball new_ball(Point p, unsigned short color) {
     b.radius = BALL_RADIUS;
     b.color = color;
     b.b_map = NULL;
+    b.spans = NULL;
     b.velocity[0] = 0;
     b.velocity[1] = 0;
     return b;
@@ -53,80 +163,23 @@ void move_ball(Ball *b, Point p) {
     b->center = p;
 }
 
-/*******************************************************************************
-*   Function Name:      fill_line
-*   Author(s):          Alexander Rathke
-*   Definition:         fills vertical line from lower to upper y value, in
-                        column x of bitmap with ball color
-*   Parameters:         ball, x val, lower y val, upper y val
-*******************************************************************************/
-void fill_line(Ball *b, uint32_t x_pos, uint32_t y_lower, uint32_t y_upper) {
-    uint32_t i;
-
-    for (i = y_lower; i <= y_upper; ++i) {
-        b->b_map[(i*BITMAP_DIM) + x_pos] = b->color;
-    }
-}
-
 /*******************************************************************************
 *   Function Name:      generate_bitmap
 *   Author(s):          Alexander Rathke
-*   Definition:         fills ball bitmap with filled circle generated by
-                        Bresenham's circle algorithm, represents ball
-*   Parameters:         ball (uses ball radius, color, modified bitmap)
+*   Definition:         points ball bitmap and row spans at compile time
+                        circle tables for ball radius, no RAM or runtime
+                        cost, color is applied when ball is drawn
+                        bitmap left unset if radius has no table
+*   Parameters:         ball (uses ball radius, modified bitmap)
 *******************************************************************************/
 void generate_bitmap(Ball *b) {
-    uint32_t i;
-    int16_t xc = (b->radius),
-            yc = (b->radius),
-            x = 0,
-            y = b->radius,
-            D = 3 - (2*(b->radius));
-
-    if (b->b_map != NULL) {
-        free_bitmap(b);
-    }
-
-    b->b_map = malloc((BITMAP_DIM * BITMAP_DIM) * sizeof(unsigned short));
-
-    // Fill as black (background color)
-    for(i = 0; i < (BITMAP_DIM * BITMAP_DIM); ++i) {
-        b->b_map[i] = Black;
-    }
-
-
-    while(x <= y) {
-        fill_line(b, xc+x, yc-y, yc+y);
-        fill_line(b, xc-x, yc-y, yc+y);
-        fill_line(b, xc+y, yc-x, yc+x);
-        fill_line(b, xc-y, yc-x, yc+x);
-
-        ++x;
-
-        if (D < 0) {
-            D = D + (4*x) + 6;
-        }
-        else {
-            D = D + (4*(x-y)) + 10;
-            --y;
-        }
-    }
-}
+    b->b_map = NULL;
+    b->spans = NULL;
 
-/*******************************************************************************
-*   Function Name:      copy_bitmap
-*   Author(s):          Alexander Rathke
-*   Definition:         deep copies bitmap from one ball to another
-*   Parameters:         ball to copy from, ball to copy to
-*******************************************************************************/
-void copy_bitmap(Ball *from, Ball*to) {
-    if (to->b_map != NULL) {
-        free_bitmap(to);
+    if (b->radius >= CIRCLE_MIN_RADIUS && b->radius <= CIRCLE_MAX_RADIUS) {
+        b->b_map = CIRCLE_MASKS[b->radius];
+        b->spans = CIRCLE_SPANS[b->radius];
     }
-
-    to->b_map = malloc((BITMAP_DIM * BITMAP_DIM) * sizeof(unsigned short));
-
-    memcpy(to->b_map, from->b_map, (BITMAP_DIM * BITMAP_DIM)* sizeof(unsigned short));
 }
 
 /*******************************************************************************
@@ -153,41 +206,23 @@ void set_ball_velocity(Ball *b, int8_t x_speed, int8_t y_speed) {
 /*******************************************************************************
 *   Function Name:      print_bitmap
 *   Author(s):          Alexander Rathke
-*   Definition:         prints ball bitmap to serial port
+*   Definition:         prints ball bitmap colors to serial port
 *   Parameters:         ball
 *******************************************************************************/
 void print_bitmap(Ball *b) {
-    uint32_t i;
+    uint32_t row,
+             col,
+             dim = (2 * b->radius) + 1;
 
-    for(i = 0; i < (BITMAP_DIM*BITMAP_DIM); ++i) {
-        printf("%d ", b->b_map[i]);
-        if ((i+1) % BITMAP_DIM == 0) {
-            printf("\r\n");
-        }
+    if (b->b_map == NULL) {
+        return;
     }
-}
 
-/*******************************************************************************
-*   Function Name:      draw_ball
-*   Author(s):          Alexander Rathke
-*   Definition:         draws ball on LCD, uses bitmap and ball position, must
-                        generate bitmap before calling
-*   Parameters:         ball to draw
-*******************************************************************************/
-void draw_ball(Ball *b) {
-
-    if (b->b_map != NULL) {
-        uint32_t i = 0,
-                 lower_left_x = (b->center.x - b->radius),
-                 lower_left_y = (b->center.y - b->radius);
-        uint16_t x, y;
-
-        for(i = 0; i < (BITMAP_DIM*BITMAP_DIM); ++i) {
-            GLCD_SetTextColor(b->b_map[i]);
-            x = lower_left_x + (i % BITMAP_DIM);
-            y = lower_left_y + (i / BITMAP_DIM);
-            GLCD_PutPixel(x,y);
+    for(row = 0; row < dim; ++row) {
+        for(col = 0; col < dim; ++col) {
+            printf("%d ", is_bit_on(b->b_map[row], col) ? b->color : Black);
         }
+        printf("\r\n");
     }
 }
 
@@ -206,148 +241,64 @@ bool ball_is_pos_equal (Ball *a, Ball *b) {
 }
 
 /*******************************************************************************
-*   Function Name:      subtract_ball
+*   Function Name:      ball_mask
 *   Author(s):          Alexander Rathke
-*   Definition:         return ball filled with bitmap to clear portion of
-                        old ball not being overlapped by new ball
-                        does not return exact overlap, approximates with
-                        rectangles
-*   Parameters:         old ball, next ball (current position), clear color
-*   Returns:            ball filled with bitmap to clear portion of
-                        old ball not being overlapped by new ball
+*   Definition:         looks up shared flash circle bitmap for radius
+*   Parameters:         radius
+*   Returns:            one row of bits per line, NULL if radius has no table
 *******************************************************************************/
-Ball subtract_ball (Ball *old, Ball *next, unsigned short clear_color) {
-    uint32_t i,
-             cur_row,
-             cur_col;
-    int32_t col_overlap,
-            row_overlap;
-
-    uint8_t case_flag = 0;
-
-    Ball return_ball = deep_copy_ball(old);
-    return_ball.color = clear_color;
-
-    if (next->center.x < old->center.x) {
-        col_overlap = (next->center.x + next->radius) - (old->center.x - old->radius);
-        case_flag |= 1;
-    }
-    else {
-        col_overlap = (old->center.x + old->radius) - (next->center.x - next->radius);
-    }
-
-    if (col_overlap < 0) {
-        // No intersection
-        case_flag |= (1 << 2);
-    }
-
-    if (next->center.y < old->center.y) {
-        row_overlap = (next->center.y + next->radius) - (old->center.y - old->radius);
-        case_flag |= (1 << 1);
-    }
-    else {
-        row_overlap = (old->center.y + old->radius) - (next->center.y - next->radius);
-    }
-
-    if (row_overlap < 0) {
-        // No intersection
-        case_flag |= (1 << 2);
-    }
-
-    for(i = 0; i < (BITMAP_DIM * BITMAP_DIM); ++i) {
-        cur_col = (i % BITMAP_DIM);
-        cur_row = (i / BITMAP_DIM);
-
-        if (is_bit_on(case_flag, 2)) {
-            // No intersection
-            return_ball.b_map[i] = clear_color;
-        }
-        else {
-            if (case_flag == 0) {
-                // next left (or aligned) and above (or aligned) old
-                if (!( (cur_row >= (BITMAP_DIM - row_overlap - 1)) && (cur_col >= (BITMAP_DIM - col_overlap - 1)) )) {
-                    return_ball.b_map[i] = clear_color;
-                }
-            }
-            else if (case_flag == 1) {
-                // next right and above (or aligned) old
-                if (!( (cur_row >= (BITMAP_DIM - row_overlap - 1)) && (cur_col <= col_overlap) )) {
-                    return_ball.b_map[i] = clear_color;
-                }
-            }
-            else if (case_flag == 2) {
-                // next left (or aligned) and below old
-                if (!( (cur_row <= row_overlap) && (cur_col >= (BITMAP_DIM - col_overlap - 1)) )) {
-                    return_ball.b_map[i] = clear_color;
-                }
-            }
-            else if (case_flag == 3) {
-                // next right and below old
-                if (!( (cur_row <= row_overlap) && (cur_col <= col_overlap) )) {
-                    return_ball.b_map[i] = clear_color;
-                }
-            }
-        }
-    }
-
-    return return_ball;
+const uint16_t *ball_mask(uint16_t radius) {
+    return (radius <= CIRCLE_MAX_RADIUS) ? CIRCLE_MASKS[radius] : NULL;
 }
 
 /*******************************************************************************
-*   Function Name:      deep_copy_ball
+*   Function Name:      ball_spans
 *   Author(s):          Alexander Rathke
-*   Definition:         create a deep copy (needed for bitmap) of ball
-*   Parameters:         ball to copy
-*   Returns:            deep copy of ball passed as parameter
+*   Definition:         looks up shared flash circle row spans for radius
+*   Parameters:         radius
+*   Returns:            lit run of each row, NULL if radius has no table
 *******************************************************************************/
-Ball deep_copy_ball (Ball *b) {
-    Ball copy;
-    copy.center = b->center;
-    copy.radius = b->radius;
-    copy.color = b->color;
-    copy.velocity[0] = 0;
-    copy.velocity[1] = 0;
-    copy.b_map = NULL;
-
-    copy_bitmap(b, &copy);
-    return copy;
+const Span *ball_spans(uint16_t radius) {
+    return (radius <= CIRCLE_MAX_RADIUS) ? CIRCLE_SPANS[radius] : NULL;
 }
 
 /*******************************************************************************
-*   Function Name:      free_bitmap
+*   Function Name:      erase_ball_set
 *   Author(s):          Alexander Rathke
-*   Definition:         free ball bitmap, set to null
-*   Parameters:         ball
+*   Definition:         erases every ball of set using clear color, lit row
+                        spans of shared circle tables, whole bounding box
+                        for radii without a table
+*   Parameters:         ball set, clear color to cover balls with
 *******************************************************************************/
-void free_bitmap (Ball *b) {
-    free(b->b_map);
-    b->b_map = NULL;
-}
-
-/*******************************************************************************
-*   Function Name:      erase_ball
-*   Author(s):          Alexander Rathke
-*   Definition:         erases ball using clear color
-*   Parameters:         ball to erase, clear color to cover ball with
-*******************************************************************************/
-void erase_ball (Ball *b, unsigned short clear_color) {
-    uint32_t i;
-    Ball copy = deep_copy_ball(b);
-
-    if (copy.b_map == NULL) {
-        copy.b_map = malloc((BITMAP_DIM * BITMAP_DIM) * sizeof(unsigned short));
-    }
-
-    // fill with clear color
-    for(i = 0; i < (BITMAP_DIM * BITMAP_DIM); ++i) {
-        copy.b_map[i] = clear_color;
+void erase_ball_set(BallSet *s, unsigned short clear_color) {
+    const Span *spans;
+    uint16_t row,
+             dim,
+             x0,
+             y0;
+    uint8_t i;
+    uint32_t prof_start;
+
+    PROF_BEGIN(prof_start);
+
+    for (i = 0; i < s->count; ++i) {
+        spans = ball_spans(s->radius[i]);
+        dim = (2 * s->radius[i]) + 1;
+        x0 = s->x[i] - s->radius[i];
+        y0 = s->y[i] - s->radius[i];
+
+        if (spans == NULL) {
+            sprite_fill(x0, y0, dim, dim, clear_color);
+            continue;
+        }
+        for (row = 0; row < dim; ++row) {
+            sprite_fill(x0 + spans[row].start, y0 + row, spans[row].length, 1, clear_color);
+        }
     }
 
-    draw_ball(&copy);
-    free_bitmap(&copy);
+    PROF_END(PROF_ERASE_BALL_SET, prof_start);
 }
 
 /******************************************************************************
 **                            End Of File
 ******************************************************************************/
-
@@ -2,7 +2,7 @@
 * Filename:         ball.h
 * Description:      Ball object used in pong on Keil MCB1700 board
 * Author(s):        George Cowan, Alexander Rathke
-* Date Modified:    Nov. 13, 2017
+* Date Modified:    Oct. 16, 2026
 *----------------------------------------------------------------------------*/
 #ifndef _BALL_H
 #define _BALL_H
@@ -11,30 +11,50 @@ typedef struct {
     /*
     ball defined by a center point,
     radius, color, velocity, and
-    bitmap for printing
+    1-bit bitmap for printing
     */
     Point center;
     uint16_t radius;
     unsigned short color;
-    unsigned short *b_map;
+    // one row per line of bounding box, bit n set if column n is lit
+    const uint16_t *b_map;
+    // lit run of each row for circle bitmaps, NULL if bitmap is not a circle
+    const Span *spans;
     // [x speed, y speed]
     int8_t  velocity[2];
 } Ball;
 
+// most balls in one set, multi-ball mode
+#define BALL_SET_MAX            32
+
+typedef struct {
+    /*
+    many balls stored as struct of arrays so one
+    loop walks each field in turn, ball i is entry
+    i of every array, bitmaps are the shared flash
+    circle tables looked up by radius
+    */
+    uint16_t x[BALL_SET_MAX];
+    uint16_t y[BALL_SET_MAX];
+    int8_t vx[BALL_SET_MAX];
+    int8_t vy[BALL_SET_MAX];
+    uint8_t radius[BALL_SET_MAX];
+    // ball indices by left edge, kept sorted by collide_ball_set
+    uint8_t order[BALL_SET_MAX];
+    uint8_t count;
+    unsigned short color;
+} BallSet;
+
 Ball    new_ball            (Point p, unsigned short color);
 void    move_ball           (Ball *b, Point p);
-void    fill_line           (Ball *b, uint32_t x_pos, uint32_t y_lower, uint32_t y_upper);
 void    generate_bitmap     (Ball *b);
-void    copy_bitmap         (Ball *from, Ball*to);
 void    shift_ball          (Ball *b, int16_t x_shift, int16_t y_shift);
 void    set_ball_velocity   (Ball *b, int8_t x_speed, int8_t y_speed);
 void    print_bitmap        (Ball *b);
-void    draw_ball           (Ball *b);
 bool    ball_is_pos_equal   (Ball *a, Ball *b);
-Ball    subtract_ball       (Ball *old, Ball *next, unsigned short clear_color);
-Ball    deep_copy_ball      (Ball *b);
-void    free_bitmap         (Ball *b);
-void    erase_ball          (Ball *b, unsigned short clear_color);
+const uint16_t *ball_mask   (uint16_t radius);
+const Span *ball_spans      (uint16_t radius);
+void    erase_ball_set      (BallSet *s, unsigned short clear_color);
 
 #endif /* _BALL_H */
 
@@ -0,0 +1,246 @@
+/*----------------------------------------------------------------------------
+* Filename:         balls_host.c
+* Description:      Linux benchmark of multi-ball update and render cost,
+*                   plays games of 1 to 32 balls through game_step and frame
+*                   compositor as render task does and prints time to update
+*                   and to render each ball move, and LCD pixels and bus
+*                   transactions per ball move, then checks screen against
+*                   layers painted directly, not part of board image
+*                   render time includes GLCD stand-in copying pixels
+*                   build: gcc -O2 -DPROF_ENABLED=0 -Ihost -o balls_host
+*                          balls_host.c game.c collide.c bricks.c fixed.c
+*                          frame.c sprite.c ball.c rect.c point.c utils.c
+*                          prof.c host/glcd_host.c
+*                   run:   balls_host [ball moves per game]
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "GLCD.h"
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "frame.h"
+
+/*----------------------------------------------------------------------------
+ *      Benchmark Constants
+ *---------------------------------------------------------------------------*/
+
+#define DEFAULT_MOVES           20000
+
+/*----------------------------------------------------------------------------
+ *      Benchmark Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t moves;
+    uint64_t update_ns;
+    uint64_t render_ns;
+    uint32_t pixels;
+    uint32_t transactions;
+} Cost;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+static const uint8_t    BALL_COUNTS[] = {1, 2, 4, 8, 16, BALL_SET_MAX};
+
+static Game             game;
+static unsigned short   expected[HEIGHT][WIDTH];
+static uint32_t         errors = 0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      now_ns
+*   Author(s):          George Cowan
+*   Definition:         reads monotonic clock
+*   Returns:            nanoseconds
+*******************************************************************************/
+static uint64_t now_ns(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t) t.tv_sec * 1000000000u) + t.tv_nsec;
+}
+
+/*******************************************************************************
+*   Function Name:      paint_rect
+*   Author(s):          George Cowan
+*   Definition:         paints rectangle into expected screen
+*   Parameters:         rectangle
+*******************************************************************************/
+static void paint_rect(const Rect *r) {
+    uint16_t x, y;
+
+    for (y = r->b_left.y; y <= r->t_right.y; ++y) {
+        for (x = r->b_left.x; x <= r->t_right.x; ++x) {
+            expected[y][x] = r->color;
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      compare
+*   Author(s):          George Cowan
+*   Definition:         paints layers back to front into expected screen,
+                        balls lit pixels only, and checks LCD stand-in screen
+                        against it
+*   Parameters:         number of balls
+*******************************************************************************/
+static void compare(uint8_t count) {
+    const BallSet *s = &game.balls;
+    const uint16_t *mask;
+    uint16_t x, y, row, col, dim;
+    uint8_t i;
+
+    memset(expected, 0, sizeof(expected));
+    paint_rect(&game.border_left);
+    paint_rect(&game.border_right);
+    paint_rect(&game.paddle_top);
+    paint_rect(&game.paddle_bottom);
+    for (i = 0; i < s->count; ++i) {
+        mask = ball_mask(s->radius[i]);
+        dim = (2 * s->radius[i]) + 1;
+        for (row = 0; row < dim; ++row) {
+            for (col = 0; col < dim; ++col) {
+                if (mask[row] & (1u << col)) {
+                    expected[s->y[i] - s->radius[i] + row][s->x[i] - s->radius[i] + col] = s->color;
+                }
+            }
+        }
+    }
+
+    for (y = 0; y < HEIGHT; ++y) {
+        for (x = 0; x < WIDTH; ++x) {
+            if (glcd_screen[y][x] != expected[y][x]) {
+                if (errors < 10) {
+                    printf("%u balls: pixel %u,%u is %04x, expected %04x\n",
+                           count, x, y, glcd_screen[y][x], expected[y][x]);
+                }
+                ++errors;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      run
+*   Author(s):          George Cowan
+*   Definition:         plays game until enough balls have moved, steps game
+                        then marks moved balls and flushes as render task
+                        does, paddles stay still so only balls are counted,
+                        whole screen is redrawn after a match is over and is
+                        not counted
+*   Parameters:         number of balls, ball moves wanted, cost to fill
+*******************************************************************************/
+static void run(uint8_t count, uint32_t moves, Cost *c) {
+    GameInput in = { 0, 0, 0 };
+    BallSet old;
+    uint64_t start;
+    uint16_t events;
+    uint8_t i;
+
+    game_init(&game, count, false);
+    game.paddle_bottom.color = Blue;
+    game.paddle_top.color = Red;
+    game.border_left.color = DarkGrey;
+    game.border_right.color = DarkGrey;
+    game.balls.color = Yellow;
+    in.paddle_top_y = game.paddle_top.b_left.y;
+    in.paddle_bottom_y = game.paddle_bottom.b_left.y;
+    memset(c, 0, sizeof(*c));
+
+    GLCD_Init();
+    frame_mark_dirty(0, 0, WIDTH - 1, HEIGHT - 1);
+    frame_flush();
+
+    while (c->moves < moves) {
+        old = game.balls;
+        start = now_ns();
+        events = game_step(&game, &in);
+        c->update_ns += now_ns() - start;
+
+        if (events & GAME_EVENT_GAME_OVER) {
+            game_new_match(&game);
+            frame_mark_dirty(0, 0, WIDTH - 1, HEIGHT - 1);
+            frame_flush();
+            continue;
+        }
+
+        glcd_reset_stats();
+        start = now_ns();
+        for (i = 0; i < count; ++i) {
+            if (old.x[i] != game.balls.x[i] || old.y[i] != game.balls.y[i]) {
+                frame_mark_circle_move(old.x[i], old.y[i], game.balls.x[i], game.balls.y[i],
+                                       game.balls.radius[i]);
+            }
+        }
+        frame_flush();
+        c->render_ns += now_ns() - start;
+        c->pixels += glcd_pixels;
+        c->transactions += glcd_transactions;
+
+        if (events & GAME_EVENT_BALL_MOVED) {
+            c->moves += count;
+        }
+    }
+
+    compare(count);
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         runs each ball count and prints cost per ball move,
+                        update time of ticks between ball moves is counted
+                        in with next ball move
+*   Parameters:         ball moves per game
+*   Returns:            0 if every screen matched
+*******************************************************************************/
+int main(int argc, char **argv) {
+    Cost c;
+    uint32_t moves = (argc > 1) ? (uint32_t) atoi(argv[1]) : DEFAULT_MOVES;
+    uint8_t i;
+
+    if (moves == 0) {
+        return 1;
+    }
+
+    frame_add_rect(&game.border_left);
+    frame_add_rect(&game.border_right);
+    frame_add_rect(&game.paddle_top);
+    frame_add_rect(&game.paddle_bottom);
+    frame_add_ball_set(&game.balls);
+
+    printf("%u ball moves per game, per ball move costs\n", moves);
+    printf("%-6s %12s %12s %10s %14s\n", "balls", "update ns", "render ns", "pixels",
+           "transactions");
+    for (i = 0; i < sizeof(BALL_COUNTS); ++i) {
+        run(BALL_COUNTS[i], moves, &c);
+        printf("%-6u %12.1f %12.1f %10.1f %14.1f\n", BALL_COUNTS[i],
+               (double) c.update_ns / c.moves, (double) c.render_ns / c.moves,
+               (double) c.pixels / c.moves, (double) c.transactions / c.moves);
+    }
+    printf("pixel errors %u %s\n", errors, errors == 0 ? "ok" : "FAILED");
+
+    return errors == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,198 @@
+/*----------------------------------------------------------------------------
+* Filename:         bricks.c
+* Description:      Destructible brick grid for pong on Keil MCB1700 board,
+*                   one bit per cell so ball collisions are looked up by cell
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+
+/*----------------------------------------------------------------------------
+ *      Bricks Constants
+ *---------------------------------------------------------------------------*/
+
+// cells one sweep may test, enough for a radius 7 ball moving 31 pixels
+// along both axes
+#define BRICK_MAX_CANDIDATES    64
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+// standing bricks near the ball being swept, rebuilt every sweep
+static Rect             candidate_rects[BRICK_MAX_CANDIDATES];
+static Collider         candidates[BRICK_MAX_CANDIDATES];
+static uint16_t         candidate_cells[BRICK_MAX_CANDIDATES];
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      bricks_clear
+*   Author(s):          Alexander Rathke
+*   Definition:         removes every brick, cells that had one are marked
+                        changed so they are repainted
+*   Parameters:         bricks (modified)
+*******************************************************************************/
+void bricks_clear(Bricks *k) {
+    uint16_t i;
+
+    for (i = 0; i < BRICK_WORDS; ++i) {
+        k->changed[i] |= k->cells[i];
+        k->cells[i] = 0;
+    }
+    k->count = 0;
+}
+
+/*******************************************************************************
+*   Function Name:      bricks_fill
+*   Author(s):          Alexander Rathke
+*   Definition:         places a brick in every cell of block, cells that
+                        were empty are marked changed
+*   Parameters:         bricks (modified), first and last column and row of
+                        block in cells, clamped to grid
+*******************************************************************************/
+void bricks_fill(Bricks *k, uint16_t cx0, uint16_t cy0, uint16_t cx1, uint16_t cy1) {
+    uint16_t cx,
+             cy,
+             n;
+
+    if (cx1 >= BRICK_COLS) {
+        cx1 = BRICK_COLS - 1;
+    }
+    if (cy1 >= BRICK_ROWS) {
+        cy1 = BRICK_ROWS - 1;
+    }
+
+    for (cy = cy0; cy <= cy1; ++cy) {
+        for (cx = cx0; cx <= cx1; ++cx) {
+            n = BRICK_INDEX(cx, cy);
+            if (!BRICK_BIT(k->cells, n)) {
+                k->cells[n >> 5] |= (1u << (n & 31));
+                k->changed[n >> 5] |= (1u << (n & 31));
+                ++k->count;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      bricks_test
+*   Author(s):          Alexander Rathke
+*   Definition:         checks if brick stands in cell
+*   Parameters:         bricks, column and row of cell
+*   Returns:            true if cell has brick, false if empty or off grid
+*******************************************************************************/
+bool bricks_test(const Bricks *k, int16_t cx, int16_t cy) {
+    if (cx < 0 || cy < 0 || cx >= BRICK_COLS || cy >= BRICK_ROWS) {
+        return false;
+    }
+    return BRICK_BIT(k->cells, BRICK_INDEX(cx, cy)) != 0;
+}
+
+/*******************************************************************************
+*   Function Name:      bricks_destroy
+*   Author(s):          Alexander Rathke
+*   Definition:         removes brick from cell and marks cell changed, so
+                        only that cell is repainted
+*   Parameters:         bricks (modified), cell number
+*******************************************************************************/
+void bricks_destroy(Bricks *k, uint16_t cell) {
+    if (cell >= BRICK_CELLS || !BRICK_BIT(k->cells, cell)) {
+        return;
+    }
+    k->cells[cell >> 5] &= ~(1u << (cell & 31));
+    k->changed[cell >> 5] |= (1u << (cell & 31));
+    --k->count;
+}
+
+/*******************************************************************************
+*   Function Name:      bricks_sweep
+*   Author(s):          George Cowan
+*   Definition:         finds first brick ball touches while moving, only
+                        cells under swept bounding box of ball are looked
+                        up, so cost depends on ball speed and not on number
+                        of bricks
+                        a corner hit where the neighbouring cell toward the
+                        ball also has a brick is treated as a hit on the
+                        face of that row or column, so walls of bricks
+                        bounce like one flat surface
+*   Parameters:         bricks, ball center, ball radius, move in x and y,
+                        cell hit (modified only on contact)
+*   Returns:            earliest contact, index COLLIDE_NONE if move is clear
+*******************************************************************************/
+Contact bricks_sweep(const Bricks *k, Point center, uint16_t radius, int16_t dx, int16_t dy,
+                     uint16_t *cell) {
+    Contact c;
+    int16_t reach = radius + 1,
+            x0 = ((dx < 0) ? center.x + dx : center.x) - reach,
+            x1 = ((dx > 0) ? center.x + dx : center.x) + reach,
+            y0 = ((dy < 0) ? center.y + dy : center.y) - reach,
+            y1 = ((dy > 0) ? center.y + dy : center.y) + reach,
+            cx,
+            cy;
+    uint8_t n = 0;
+    bool x_blocked,
+         y_blocked;
+
+    c.index = COLLIDE_NONE;
+    if (k->count == 0) {
+        return c;
+    }
+
+    x0 = (x0 < 0) ? 0 : (x0 >> BRICK_SHIFT);
+    y0 = (y0 < 0) ? 0 : (y0 >> BRICK_SHIFT);
+    x1 = (x1 >> BRICK_SHIFT);
+    y1 = (y1 >> BRICK_SHIFT);
+
+    for (cy = y0; cy <= y1 && n < BRICK_MAX_CANDIDATES; ++cy) {
+        for (cx = x0; cx <= x1 && n < BRICK_MAX_CANDIDATES; ++cx) {
+            if (!bricks_test(k, cx, cy)) {
+                continue;
+            }
+            // lit 7 x 7 pixels of cell, gap is not solid
+            candidate_rects[n].b_left.x = cx << BRICK_SHIFT;
+            candidate_rects[n].b_left.y = cy << BRICK_SHIFT;
+            candidate_rects[n].t_right.x = (cx << BRICK_SHIFT) + BRICK_SIZE - 2;
+            candidate_rects[n].t_right.y = (cy << BRICK_SHIFT) + BRICK_SIZE - 2;
+            candidates[n].rect = &candidate_rects[n];
+            candidates[n].sensor = false;
+            candidate_cells[n] = BRICK_INDEX(cx, cy);
+            ++n;
+        }
+    }
+
+    c = collide_sweep(center, radius, dx, dy, candidates, n);
+    if (c.index == COLLIDE_NONE) {
+        return c;
+    }
+
+    *cell = candidate_cells[c.index];
+    if (c.normal[0] != 0 && c.normal[1] != 0) {
+        cx = *cell % BRICK_COLS;
+        cy = *cell / BRICK_COLS;
+        x_blocked = bricks_test(k, cx + c.normal[0], cy);
+        y_blocked = bricks_test(k, cx, cy + c.normal[1]);
+        if (x_blocked && !y_blocked) {
+            c.normal[0] = 0;
+        }
+        else if (y_blocked && !x_blocked) {
+            c.normal[1] = 0;
+        }
+    }
+
+    return c;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,46 @@
+/*----------------------------------------------------------------------------
+* Filename:         bricks.h
+* Description:      Destructible brick grid for pong on Keil MCB1700 board,
+*                   one bit per cell so ball collisions are looked up by cell
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _BRICKS_H
+#define _BRICKS_H
+
+// grid covers whole LCD in 8 x 8 pixel cells, bricks are drawn 7 x 7 so
+// neighbours show a one pixel gap
+#define BRICK_SHIFT             3
+#define BRICK_SIZE              (1 << BRICK_SHIFT)
+#define BRICK_COLS              (320 / BRICK_SIZE)
+#define BRICK_ROWS              (240 / BRICK_SIZE)
+#define BRICK_CELLS             (BRICK_COLS * BRICK_ROWS)
+#define BRICK_WORDS             ((BRICK_CELLS + 31) / 32)
+
+typedef struct {
+    /*
+    bit n of cells is set if brick stands in cell n,
+    cells are numbered row by row, changed marks cells
+    to repaint and is cleared by whoever draws them
+    */
+    uint32_t cells[BRICK_WORDS];
+    uint32_t changed[BRICK_WORDS];
+    uint16_t count;
+    unsigned short color;
+} Bricks;
+
+#define BRICK_INDEX(cx, cy)     (((cy) * BRICK_COLS) + (cx))
+#define BRICK_BIT(bits, n)      ((bits)[(n) >> 5] & (1u << ((n) & 31)))
+
+void        bricks_clear    (Bricks *k);
+void        bricks_fill     (Bricks *k, uint16_t cx0, uint16_t cy0, uint16_t cx1, uint16_t cy1);
+bool        bricks_test     (const Bricks *k, int16_t cx, int16_t cy);
+void        bricks_destroy  (Bricks *k, uint16_t cell);
+Contact     bricks_sweep    (const Bricks *k, Point center, uint16_t radius, int16_t dx, int16_t dy,
+                             uint16_t *cell);
+
+#endif /* _BRICKS_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,193 @@
+/*----------------------------------------------------------------------------
+* Filename:         clear_host.c
+* Description:      Linux check of pixels cleared per frame when a ball
+*                   moves one step, for every bounce velocity of slow and
+*                   fast ball speeds, compares pixels frame_flush sends for
+*                   a moved ball against exact old-minus-new difference and
+*                   changed pixels found by brute force and against erasing
+*                   whole old ball, and checks screen after every flush, not
+*                   part of board image
+*                   build: gcc -Ihost -o clear_host clear_host.c frame.c
+*                          sprite.c ball.c rect.c point.c utils.c prof.c
+*                          host/glcd_host.c -lm
+*                   run:   clear_host
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "GLCD.h"
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "frame.h"
+
+/*----------------------------------------------------------------------------
+ *      Check Constants
+ *---------------------------------------------------------------------------*/
+
+#define RADIUS                  6
+#define DIM                     ((2 * RADIUS) + 1)
+#define START_X                 160
+#define START_Y                 120
+
+// ball speeds and bounce angles, same as bounce table in game.c
+#define SPEEDS                  2
+#define BOUNCE_MIN_ANGLE        15
+#define BOUNCE_MAX_ANGLE        80
+#define BOUNCE_HALF_WIDTH       26
+#define BOUNCE_PI               3.14159265358979
+
+/*----------------------------------------------------------------------------
+ *      Check Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t moves;
+    // pixels of old ball not covered by new ball, least that must be cleared
+    uint32_t exact;
+    // pixels lit in only one of old and new, least that must be sent
+    uint32_t changed;
+    // pixels and bus transactions sent by frame_flush
+    uint32_t sent;
+    uint32_t transactions;
+} Totals;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+static const uint8_t    SPEED_ARRAY[SPEEDS] = {7, 15};
+
+static BallSet          balls;
+static uint32_t         errors = 0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      is_lit
+*   Author(s):          George Cowan
+*   Definition:         checks if pixel is lit by ball at center
+*   Parameters:         ball center x and y, pixel x and y
+*   Returns:            true if pixel is inside ball mask
+*******************************************************************************/
+static bool is_lit(int16_t cx, int16_t cy, int16_t x, int16_t y) {
+    int16_t row = y - cy + RADIUS,
+            col = x - cx + RADIUS;
+
+    if (row < 0 || row >= DIM || col < 0 || col >= DIM) {
+        return false;
+    }
+    return (ball_mask(RADIUS)[row] & (1u << col)) != 0;
+}
+
+/*******************************************************************************
+*   Function Name:      move
+*   Author(s):          George Cowan
+*   Definition:         moves ball one step as render task does, marks old
+                        and new spans and flushes, then checks screen and adds
+                        pixel counts to totals
+*   Parameters:         x and y step, totals (modified)
+*******************************************************************************/
+static void move(int16_t vx, int16_t vy, Totals *t) {
+    int16_t x, y,
+            new_x = START_X + vx,
+            new_y = START_Y + vy;
+
+    // start from ball drawn at start on a clear screen
+    balls.x[0] = START_X;
+    balls.y[0] = START_Y;
+    GLCD_Init();
+    frame_mark_dirty(0, 0, WIDTH - 1, HEIGHT - 1);
+    frame_flush();
+
+    balls.x[0] = new_x;
+    balls.y[0] = new_y;
+    glcd_reset_stats();
+    frame_mark_circle_move(START_X, START_Y, new_x, new_y, RADIUS);
+    frame_flush();
+
+    ++t->moves;
+    t->sent += glcd_pixels;
+    t->transactions += glcd_transactions;
+
+    for (y = 0; y < HEIGHT; ++y) {
+        for (x = 0; x < WIDTH; ++x) {
+            if (is_lit(START_X, START_Y, x, y) != is_lit(new_x, new_y, x, y)) {
+                ++t->changed;
+                if (is_lit(START_X, START_Y, x, y)) {
+                    ++t->exact;
+                }
+            }
+            if (glcd_screen[y][x] != (is_lit(new_x, new_y, x, y) ? Yellow : Black)) {
+                if (errors < 10) {
+                    printf("step %d,%d: pixel %d,%d is %04x\n", vx, vy, x, y, glcd_screen[y][x]);
+                }
+                ++errors;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         moves ball by every bounce velocity of each speed in
+                        all four directions and prints mean pixels per move,
+                        whole ball is old ball erased and new drawn
+*   Returns:            0 if screen was right after every move
+*******************************************************************************/
+int main(void) {
+    Totals t;
+    double rad;
+    int16_t vx, vy;
+    uint16_t lit = 0;
+    uint8_t s, o, d;
+
+    for (o = 0; o < DIM; ++o) {
+        for (d = 0; d < DIM; ++d) {
+            lit += is_lit(RADIUS, RADIUS, d, o);
+        }
+    }
+
+    balls.count = 1;
+    balls.radius[0] = RADIUS;
+    balls.order[0] = 0;
+    balls.color = Yellow;
+    frame_add_ball_set(&balls);
+
+    printf("radius %u ball, mean pixels per one step move\n", RADIUS);
+    printf("%-6s %6s %12s %12s %10s %10s %14s\n",
+           "speed", "moves", "whole ball", "exact clear", "changed", "sent", "transactions");
+    for (s = 0; s < SPEEDS; ++s) {
+        memset(&t, 0, sizeof(t));
+        for (o = 0; o <= BOUNCE_HALF_WIDTH; ++o) {
+            rad = (((BOUNCE_MIN_ANGLE - BOUNCE_MAX_ANGLE) / (BOUNCE_HALF_WIDTH * 1.0)) * o +
+                   BOUNCE_MAX_ANGLE) * BOUNCE_PI / 180.0;
+            vx = (int16_t) ceil(SPEED_ARRAY[s] * sin(rad));
+            vy = (int16_t) floor(SPEED_ARRAY[s] * cos(rad));
+            for (d = 0; d < 4; ++d) {
+                move((d & 1) ? -vx : vx, (d & 2) ? -vy : vy, &t);
+            }
+        }
+        printf("%-6u %6u %12u %12.1f %10.1f %10.1f %14.1f\n", SPEED_ARRAY[s], t.moves, 2 * lit,
+               (double) t.exact / t.moves, (double) t.changed / t.moves,
+               (double) t.sent / t.moves, (double) t.transactions / t.moves);
+    }
+    printf("pixel errors %u %s\n", errors, errors == 0 ? "ok" : "FAILED");
+
+    return errors == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
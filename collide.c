@@ -0,0 +1,373 @@
+/*----------------------------------------------------------------------------
+* Filename:         collide.c
+* Description:      Swept circle against rectangle collision for pong on Keil
+*                   MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+
+/*----------------------------------------------------------------------------
+ *      Collide Constants
+ *---------------------------------------------------------------------------*/
+
+// slab times for an axis the ball does not move along
+#define TIME_NEVER_MIN          ((fixed_t) -0x7FFFFFFF)
+#define TIME_NEVER_MAX          ((fixed_t) 0x7FFFFFFF)
+
+// ball to ball bounces may not speed a ball past this along either axis
+#define BALL_SPEED_LIMIT        31
+// nor leave it slower than this toward paddles, slowest paddle bounce
+// gives the same, so no ball bounces between borders forever
+#define BALL_SPEED_MIN_X        2
+
+#define BALL_LEFT(s, i)         ((int32_t) (s)->x[i] - (s)->radius[i])
+#define BALL_RIGHT(s, i)        ((int32_t) (s)->x[i] + (s)->radius[i])
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      slab_times
+*   Author(s):          George Cowan
+*   Definition:         times ball center enters and leaves band lo to hi
+                        along one axis
+*   Parameters:         start position, move along axis, band limits, entry
+                        and exit time (modified)
+*   Returns:            false if center never is inside band
+*******************************************************************************/
+static bool slab_times(int32_t p, int32_t d, int32_t lo, int32_t hi, fixed_t *enter, fixed_t *leave) {
+    if (d == 0) {
+        *enter = TIME_NEVER_MIN;
+        *leave = TIME_NEVER_MAX;
+        return (p >= lo && p <= hi);
+    }
+
+    if (d > 0) {
+        *enter = fixed_div(lo - p, d);
+        *leave = fixed_div(hi - p, d);
+    }
+    else {
+        *enter = fixed_div(hi - p, d);
+        *leave = fixed_div(lo - p, d);
+    }
+    return true;
+}
+
+/*******************************************************************************
+*   Function Name:      move_part
+*   Author(s):          George Cowan
+*   Definition:         whole pixels moved along one axis by time of contact
+                        contact times are rounded down, so a move the ball
+                        exactly completes could fall a hair short of its last
+                        pixel and lose it, one unit of time is added back,
+                        slab times are multiples of 1 / move so this never
+                        reaches a pixel the ball does not
+*   Parameters:         time of contact in Q16.16, move along axis
+*   Returns:            pixels moved, rounded towards zero
+*******************************************************************************/
+static int32_t move_part(fixed_t time, int32_t d) {
+    return fixed_trunc((time + 1) * d);
+}
+
+/*******************************************************************************
+*   Function Name:      sweep_corner
+*   Author(s):          George Cowan
+*   Definition:         time ball center moving along d first comes within
+                        reach of corner pixel, ray against circle
+*   Parameters:         start position relative to corner, move, reach
+*   Returns:            time of contact in Q16.16, negative if missed
+*******************************************************************************/
+static fixed_t sweep_corner(int32_t fx, int32_t fy, int32_t dx, int32_t dy, int32_t reach) {
+    int32_t a = (dx * dx) + (dy * dy),
+            b = (fx * dx) + (fy * dy),
+            c = (fx * fx) + (fy * fy) - (reach * reach),
+            disc;
+    uint32_t root;
+
+    disc = (b * b) - (a * c);
+    if (a == 0 || disc < 0) {
+        return -1;
+    }
+
+    // round root up so contact is never late
+    root = fixed_isqrt(disc);
+    if (root * root < (uint32_t) disc) {
+        ++root;
+    }
+
+    return fixed_div(-b - (int32_t) root, a);
+}
+
+/*******************************************************************************
+*   Function Name:      sweep_rect
+*   Author(s):          George Cowan
+*   Definition:         earliest contact of moving ball with one rectangle,
+                        rectangle grown by ball reach with rounded corners
+                        is swept against ball center
+                        contact is reported only when entering, a ball
+                        already overlapping is let out
+*   Parameters:         start center, move, reach (radius + 1 for solid so
+                        contact is the pixel before overlap, 0 for sensor),
+                        collider, contact (modified on hit)
+*   Returns:            true if hit within move
+*******************************************************************************/
+static bool sweep_rect(int32_t px, int32_t py, int32_t dx, int32_t dy, int32_t reach,
+                       const Collider *col, Contact *c) {
+    int32_t lo_x = col->rect->b_left.x,
+            hi_x = col->rect->t_right.x,
+            lo_y = col->rect->b_left.y,
+            hi_y = col->rect->t_right.y,
+            hit_x,
+            hit_y,
+            corner_x,
+            corner_y;
+    fixed_t enter_x, leave_x,
+            enter_y, leave_y,
+            enter,
+            leave;
+
+    if (!slab_times(px, dx, lo_x - reach, hi_x + reach, &enter_x, &leave_x) ||
+        !slab_times(py, dy, lo_y - reach, hi_y + reach, &enter_y, &leave_y)) {
+        return false;
+    }
+
+    enter = (enter_x > enter_y) ? enter_x : enter_y;
+    leave = (leave_x < leave_y) ? leave_x : leave_y;
+    if (enter > leave || leave < 0 || enter > FIXED_ONE) {
+        return false;
+    }
+
+    if (enter < 0) {
+        // starts in grown box, only clear of rectangle if beside a corner
+        hit_x = px;
+        hit_y = py;
+    }
+    else {
+        c->time = enter;
+        c->normal[0] = 0;
+        c->normal[1] = 0;
+        c->center.x = px + move_part(enter, dx);
+        c->center.y = py + move_part(enter, dy);
+
+        // entry face, center is placed exactly on it
+        if (enter_x >= enter_y) {
+            c->normal[0] = (dx > 0) ? -1 : 1;
+            c->center.x = (dx > 0) ? (lo_x - reach) : (hi_x + reach);
+        }
+        else {
+            c->normal[1] = (dy > 0) ? -1 : 1;
+            c->center.y = (dy > 0) ? (lo_y - reach) : (hi_y + reach);
+        }
+
+        hit_x = c->center.x;
+        hit_y = c->center.y;
+    }
+
+    if ((hit_x >= lo_x && hit_x <= hi_x) || (hit_y >= lo_y && hit_y <= hi_y) || reach == 0) {
+        // face hit, or ball already overlaps and is let out
+        return (enter >= 0);
+    }
+
+    // beside a corner of grown box, rounded corner decides
+    corner_x = (hit_x < lo_x) ? lo_x : hi_x;
+    corner_y = (hit_y < lo_y) ? lo_y : hi_y;
+    enter = sweep_corner(px - corner_x, py - corner_y, dx, dy, reach);
+    if (enter < 0 || enter > FIXED_ONE) {
+        return false;
+    }
+
+    // corner faces both ways, reflecting any speed heading into it keeps
+    // ball from sliding onto the rectangle after the bounce
+    c->time = enter;
+    c->center.x = px + move_part(enter, dx);
+    c->center.y = py + move_part(enter, dy);
+    c->normal[0] = (hit_x < lo_x) ? -1 : 1;
+    c->normal[1] = (hit_y < lo_y) ? -1 : 1;
+    return true;
+}
+
+/*******************************************************************************
+*   Function Name:      collide_sweep
+*   Author(s):          George Cowan
+*   Definition:         finds first collider ball touches while moving, cost
+                        is fixed per collider
+                        ties go to the collider listed first
+*   Parameters:         ball center, ball radius, move in x and y, colliders,
+                        number of colliders
+*   Returns:            earliest contact, index COLLIDE_NONE if move is clear
+*******************************************************************************/
+Contact collide_sweep(Point center, uint16_t radius, int16_t dx, int16_t dy,
+                      const Collider *colliders, uint8_t count) {
+    Contact best,
+            hit;
+    uint8_t i;
+
+    best.index = COLLIDE_NONE;
+    best.time = FIXED_ONE + 1;
+
+    for (i = 0; i < count; ++i) {
+        if (sweep_rect(center.x, center.y, dx, dy, colliders[i].sensor ? 0 : radius + 1,
+                       &colliders[i], &hit) && hit.time < best.time) {
+            best = hit;
+            best.index = i;
+        }
+    }
+
+    return best;
+}
+
+/*******************************************************************************
+*   Function Name:      collide_reflect
+*   Author(s):          George Cowan
+*   Definition:         bounces velocity off surface of contact, only speeds
+                        heading into surface are flipped
+*   Parameters:         [x speed, y speed] (modified), contact
+*******************************************************************************/
+void collide_reflect(int8_t *velocity, const Contact *c) {
+    if (c->normal[0] * velocity[0] < 0) {
+        velocity[0] = -velocity[0];
+    }
+    if (c->normal[1] * velocity[1] < 0) {
+        velocity[1] = -velocity[1];
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      round_div
+*   Author(s):          George Cowan
+*   Definition:         integer division rounded to nearest, halves away from
+                        zero, same result for num and -num apart from sign
+*   Parameters:         numerator, denominator (above zero)
+*   Returns:            rounded quotient
+*******************************************************************************/
+static int32_t round_div(int32_t num, int32_t den) {
+    if (num >= 0) {
+        return (num + (den / 2)) / den;
+    }
+    return -((-num + (den / 2)) / den);
+}
+
+/*******************************************************************************
+*   Function Name:      clamp_speed
+*   Author(s):          George Cowan
+*   Definition:         limits one speed to BALL_SPEED_LIMIT either way
+*   Parameters:         speed
+*   Returns:            limited speed
+*******************************************************************************/
+static int8_t clamp_speed(int32_t v) {
+    if (v > BALL_SPEED_LIMIT) {
+        return BALL_SPEED_LIMIT;
+    }
+    else if (v < -BALL_SPEED_LIMIT) {
+        return -BALL_SPEED_LIMIT;
+    }
+    return (int8_t) v;
+}
+
+/*******************************************************************************
+*   Function Name:      clamp_speed_x
+*   Author(s):          George Cowan
+*   Definition:         limits speed toward paddles to BALL_SPEED_LIMIT and
+                        raises it to at least BALL_SPEED_MIN_X, keeping its
+                        direction, a stopped ball goes the way it was pushed
+*   Parameters:         speed, direction to use if speed is 0 (+1 or -1)
+*   Returns:            limited speed
+*******************************************************************************/
+static int8_t clamp_speed_x(int32_t v, int8_t away) {
+    if (v >= BALL_SPEED_MIN_X || v <= -BALL_SPEED_MIN_X) {
+        return clamp_speed(v);
+    }
+    if (v == 0) {
+        v = away;
+    }
+    return (v > 0) ? BALL_SPEED_MIN_X : -BALL_SPEED_MIN_X;
+}
+
+/*******************************************************************************
+*   Function Name:      collide_ball_set
+*   Author(s):          George Cowan
+*   Definition:         bounces touching balls of set off each other as equal
+                        masses, velocity along line between centers is traded
+                        and the rest kept, pairs already moving apart are
+                        left alone so balls never stick, x speed is kept
+                        from falling below BALL_SPEED_MIN_X
+                        order is re-sorted by left edge each call, it barely
+                        changes between steps so the insertion sort is about
+                        one pass, and each ball is only tested against those
+                        whose left edge is within its reach, so cost grows
+                        with number of balls rather than number of pairs
+*   Parameters:         ball set (velocities and order modified)
+*   Returns:            number of pairs bounced
+*******************************************************************************/
+uint8_t collide_ball_set(BallSet *s) {
+    uint8_t i,
+            j,
+            a,
+            b,
+            hits = 0;
+    int32_t dx,
+            dy,
+            d2,
+            reach,
+            rel,
+            ix,
+            iy;
+
+    for (i = 1; i < s->count; ++i) {
+        a = s->order[i];
+        j = i;
+        while (j > 0 && BALL_LEFT(s, s->order[j-1]) > BALL_LEFT(s, a)) {
+            s->order[j] = s->order[j-1];
+            --j;
+        }
+        s->order[j] = a;
+    }
+
+    for (i = 0; i < s->count; ++i) {
+        a = s->order[i];
+        for (j = i + 1; j < s->count; ++j) {
+            b = s->order[j];
+            reach = s->radius[a] + s->radius[b] + 1;
+            // later balls start even further right
+            if (BALL_LEFT(s, b) - BALL_RIGHT(s, a) > 1) {
+                break;
+            }
+
+            dx = (int32_t) s->x[b] - s->x[a];
+            dy = (int32_t) s->y[b] - s->y[a];
+            d2 = (dx * dx) + (dy * dy);
+            if (d2 == 0 || d2 > reach * reach) {
+                continue;
+            }
+
+            // closing speed along centers, scaled by distance
+            rel = ((s->vx[b] - s->vx[a]) * dx) + ((s->vy[b] - s->vy[a]) * dy);
+            if (rel >= 0) {
+                continue;
+            }
+
+            ix = round_div(rel * dx, d2);
+            iy = round_div(rel * dy, d2);
+            s->vx[a] = clamp_speed_x(s->vx[a] + ix, (dx > 0) ? -1 : 1);
+            s->vy[a] = clamp_speed(s->vy[a] + iy);
+            s->vx[b] = clamp_speed_x(s->vx[b] - ix, (dx > 0) ? 1 : -1);
+            s->vy[b] = clamp_speed(s->vy[b] - iy);
+            ++hits;
+        }
+    }
+
+    return hits;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
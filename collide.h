@@ -0,0 +1,44 @@
+/*----------------------------------------------------------------------------
+* Filename:         collide.h
+* Description:      Swept circle against rectangle collision for pong on Keil
+*                   MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _COLLIDE_H
+#define _COLLIDE_H
+
+#define COLLIDE_NONE            (-1)
+// most contacts resolved in one ball step, bounds step cost
+#define COLLIDE_MAX_BOUNCES     4
+
+typedef struct {
+    /*
+    rectangle ball can hit, sensors only report the
+    ball center crossing into them and have no corners
+    */
+    Rect *rect;
+    bool sensor;
+} Collider;
+
+typedef struct {
+    // collider hit, COLLIDE_NONE if move is clear
+    int8_t index;
+    // fraction of move made before contact, Q16.16
+    fixed_t time;
+    // ball center at contact
+    Point center;
+    // outward normal of surface hit, each -1, 0 or 1
+    int8_t normal[2];
+} Contact;
+
+Contact collide_sweep   (Point center, uint16_t radius, int16_t dx, int16_t dy,
+                         const Collider *colliders, uint8_t count);
+void    collide_reflect (int8_t *velocity, const Contact *c);
+uint8_t collide_ball_set(BallSet *s);
+
+#endif /* _COLLIDE_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
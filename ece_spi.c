@@ -2,8 +2,9 @@
 
 // Written by Bernie Roehl, February 2017
 
+#include <stdint.h>
 #include <lpc17xx.h>
-#include "ECE_SPI.h"
+#include "ece_spi.h"
 
 #define PIN_CS (1 << 19)  // chip select is P0.19
 #define RNE 0x04          // bit in the status register to poll to see if byte was sent
@@ -24,11 +25,11 @@ void SPI_setup(void) {
 	LPC_GPIO0->FIOSET    = PIN_CS;       // set it high initially (it's active low)
 }
 
-void SPI_select() {
+void SPI_select(void) {
 	LPC_GPIO0->FIOCLR = PIN_CS;  // low to select
 }
 
-void SPI_deselect() {
+void SPI_deselect(void) {
 	LPC_GPIO0->FIOSET = PIN_CS;  // high to deselect
 }
 
@@ -64,3 +65,107 @@ uint8_t SPI_readRegister(uint8_t address) {
 		buffer[i] = SPI_xfer(i);
 	SPI_deselect();
 }
+
+// asynchronous transfers, the CPU sets up each transaction once and GPDMA
+// moves every byte, command byte and data go out as two linked items so
+// chip select stays low across a whole multi-register read; the queue is
+// in ece_spi_async.c and runs each transaction through the routines below
+
+#define SPI_RX_CHANNEL 0              // highest priority, so the RX FIFO never overruns
+#define SPI_TX_CHANNEL 1
+#define SPI_RX_DMA LPC_GPDMACH0
+#define SPI_TX_DMA LPC_GPDMACH1
+#define SPI_CHANNELS ((1 << SPI_RX_CHANNEL) | (1 << SPI_TX_CHANNEL))
+#define DMA_SSP0_TX 0                 // DMA request lines of SSP0
+#define DMA_SSP0_RX 1
+
+#define PCONP_PCGPDMA (1u << 29)
+#define DMAC_E (1u << 0)              // DMACConfig, controller enabled
+#define SSP_DMACR_RXTX 0x03           // SSP0 DMACR, RX and TX requests on
+#define DMA_SI (1u << 26)             // DMACCControl, source increments
+#define DMA_DI (1u << 27)             // ... destination increments
+#define DMA_I (1u << 31)              // ... terminal count interrupt at end of item
+#define DMA_E (1u << 0)               // DMACCConfig, channel enabled
+#define DMA_SRC(p) ((uint32_t) (p) << 1)
+#define DMA_DEST(p) ((uint32_t) (p) << 6)
+#define DMA_M2P (1u << 11)
+#define DMA_P2M (2u << 11)
+#define DMA_IE (1u << 14)             // error interrupt unmasked
+#define DMA_ITC (1u << 15)            // terminal count interrupt unmasked
+
+typedef struct {
+	uint32_t src, dst, lli, control;
+} SPI_lli;
+
+// second item of each channel, only one transaction runs at a time
+static SPI_lli spi_rx_next, spi_tx_next;
+static uint8_t spi_zero = 0;          // sent when transaction has no tx bytes
+static uint8_t spi_discard;           // received when it has no rx buffer
+
+// keeps the DMA interrupt out while the queue is changed from a task, safe
+// to nest inside the interrupt itself since the active handler keeps running
+void SPI_lock(void) {
+	NVIC_DisableIRQ(DMA_IRQn);
+}
+
+void SPI_unlock(void) {
+	NVIC_EnableIRQ(DMA_IRQn);
+}
+
+void SPI_start(SPI_transaction *t) {
+	uint32_t rx_first = 1, tx_first = 1;   // command byte, and byte clocked in with it
+	t->status = SPI_ACTIVE;
+	SPI_select();
+	LPC_GPDMA->DMACIntTCClear = SPI_CHANNELS;
+	LPC_GPDMA->DMACIntErrClr = SPI_CHANNELS;
+	if (t->length > 0) {
+		spi_rx_next.src = (uint32_t) &LPC_SSP0->DR;
+		spi_rx_next.dst = t->rx ? (uint32_t) t->rx : (uint32_t) &spi_discard;
+		spi_rx_next.lli = 0;
+		spi_rx_next.control = t->length | DMA_I | (t->rx ? DMA_DI : 0);
+		spi_tx_next.src = t->tx ? (uint32_t) t->tx : (uint32_t) &spi_zero;
+		spi_tx_next.dst = (uint32_t) &LPC_SSP0->DR;
+		spi_tx_next.lli = 0;
+		spi_tx_next.control = t->length | (t->tx ? DMA_SI : 0);
+	}
+	else
+		rx_first |= DMA_I;
+	// receiver is armed first so no byte arrives before it
+	SPI_RX_DMA->DMACCSrcAddr = (uint32_t) &LPC_SSP0->DR;
+	SPI_RX_DMA->DMACCDestAddr = (uint32_t) &spi_discard;
+	SPI_RX_DMA->DMACCLLI = t->length > 0 ? (uint32_t) &spi_rx_next : 0;
+	SPI_RX_DMA->DMACCControl = rx_first;
+	SPI_RX_DMA->DMACCConfig = DMA_E | DMA_SRC(DMA_SSP0_RX) | DMA_P2M | DMA_IE | DMA_ITC;
+	SPI_TX_DMA->DMACCSrcAddr = (uint32_t) &t->command;
+	SPI_TX_DMA->DMACCDestAddr = (uint32_t) &LPC_SSP0->DR;
+	SPI_TX_DMA->DMACCLLI = t->length > 0 ? (uint32_t) &spi_tx_next : 0;
+	SPI_TX_DMA->DMACCControl = tx_first;
+	SPI_TX_DMA->DMACCConfig = DMA_E | DMA_DEST(DMA_SSP0_TX) | DMA_M2P | DMA_IE;
+}
+
+// call after SPI_setup; SPI_xfer and the routines built on it must only be
+// used while no asynchronous transfer is pending
+void SPI_asyncSetup(void) {
+	LPC_SC->PCONP |= PCONP_PCGPDMA;
+	LPC_GPDMA->DMACConfig |= DMAC_E;
+	LPC_SSP0->DMACR = SSP_DMACR_RXTX;
+	NVIC_EnableIRQ(DMA_IRQn);
+}
+
+// telemetry channel runs without interrupts, so only SSP0 channels land here
+void DMA_IRQHandler(void) {
+	uint32_t tc = LPC_GPDMA->DMACIntTCStat & SPI_CHANNELS;
+	uint32_t err = LPC_GPDMA->DMACIntErrStat & SPI_CHANNELS;
+	LPC_GPDMA->DMACIntTCClear = tc;
+	LPC_GPDMA->DMACIntErrClr = err;
+	if (err) {
+		// stop both halves and drop whatever was received
+		SPI_RX_DMA->DMACCConfig = 0;
+		SPI_TX_DMA->DMACCConfig = 0;
+		while (LPC_SSP0->SR & RNE)
+			(void) LPC_SSP0->DR;
+		SPI_finish(SPI_ERROR);
+	}
+	else if (tc & (1 << SPI_RX_CHANNEL))
+		SPI_finish(SPI_DONE);   // last byte is in, so the last byte was sent
+}
@@ -10,3 +10,42 @@ void SPI_writeRegister(uint8_t address, uint8_t data);
 uint8_t SPI_readRegister(uint8_t address);
 void SPI_readBytes(uint8_t address, uint8_t* buffer, int nbytes);
 
+// asynchronous transfers on SSP0 by GPDMA, queued and run one at a time
+// with chip select held low for each whole transaction
+
+#define SPI_QUEUE_SIZE 8        // transactions waiting or running, power of two
+#define SPI_MAX_LENGTH 4095     // bytes after command, one DMA transfer
+
+// transaction status
+#define SPI_IDLE   0
+#define SPI_QUEUED 1
+#define SPI_ACTIVE 2
+#define SPI_DONE   3
+#define SPI_ERROR  4
+
+typedef void (*SPI_callback)(void *context);
+
+typedef struct {
+	uint8_t command;            // first byte sent, register address (| 0x80 to read)
+	const uint8_t *tx;          // bytes sent after command, NULL sends zeros
+	uint8_t *rx;                // bytes received after command, NULL discards them
+	uint16_t length;            // bytes after command
+	SPI_callback done;          // called from DMA interrupt once finished, may be NULL
+	void *context;              // passed to done
+	volatile uint8_t status;
+} SPI_transaction;
+
+void SPI_asyncSetup(void);
+int SPI_submit(SPI_transaction *t);
+int SPI_readAsync(SPI_transaction *t, uint8_t address, uint8_t *buffer, int nbytes, SPI_callback done, void *context);
+int SPI_writeAsync(SPI_transaction *t, uint8_t address, const uint8_t *data, int nbytes, SPI_callback done, void *context);
+int SPI_pending(void);
+
+// run by the queue in ece_spi_async.c, supplied by the GPDMA driver in
+// ece_spi.c on the board and by the loopback stand-in on the host
+void SPI_lock(void);            // keeps SPI_finish out while the queue changes
+void SPI_unlock(void);
+void SPI_start(SPI_transaction *t);
+// called by the driver once the running transaction is over
+void SPI_finish(uint8_t status);
+SPI_transaction *SPI_active(void);
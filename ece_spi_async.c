@@ -0,0 +1,90 @@
+/*----------------------------------------------------------------------------
+* Filename:         ece_spi_async.c
+* Description:      Queue of asynchronous SPI transactions, run one at a time
+*                   by GPDMA driver in ece_spi.c on Keil MCB1700 board or by
+*                   loopback stand-in in host/ece_spi_loopback.c on Linux,
+*                   no hardware access
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "ece_spi.h"
+
+static SPI_transaction *spi_queue[SPI_QUEUE_SIZE];
+static volatile unsigned int spi_head = 0;   // advanced by SPI_submit
+static volatile unsigned int spi_tail = 0;   // advanced at end of transaction, front is running
+
+// ends the running transaction and starts the next before calling back,
+// so the bus is not left idle while the callback runs
+void SPI_finish(uint8_t status) {
+	SPI_transaction *t = spi_queue[spi_tail & (SPI_QUEUE_SIZE - 1)];
+	SPI_deselect();
+	++spi_tail;
+	if (spi_head != spi_tail)
+		SPI_start(spi_queue[spi_tail & (SPI_QUEUE_SIZE - 1)]);
+	t->status = status;
+	if (t->done)
+		t->done(t->context);
+}
+
+// queues a transaction, it starts at once if the bus is idle; returns 0 if
+// the queue is full, the transaction is already queued or is too long;
+// the transaction and its buffers must stay in place until status is
+// SPI_DONE or SPI_ERROR, and may be submitted again from its own callback
+int SPI_submit(SPI_transaction *t) {
+	int start;
+	if (t->length > SPI_MAX_LENGTH || t->status == SPI_QUEUED || t->status == SPI_ACTIVE)
+		return 0;
+	SPI_lock();
+	if (spi_head - spi_tail >= SPI_QUEUE_SIZE) {
+		SPI_unlock();
+		return 0;
+	}
+	t->status = SPI_QUEUED;
+	spi_queue[spi_head & (SPI_QUEUE_SIZE - 1)] = t;
+	start = (spi_head == spi_tail);
+	++spi_head;
+	if (start)
+		SPI_start(t);
+	SPI_unlock();
+	return 1;
+}
+
+// reads nbytes registers from address on in one transaction, as SPI_readBytes
+// does, without the CPU touching any byte
+int SPI_readAsync(SPI_transaction *t, uint8_t address, uint8_t *buffer, int nbytes, SPI_callback done, void *context) {
+	t->command = address | 0x80;
+	t->tx = 0;
+	t->rx = buffer;
+	t->length = (uint16_t) nbytes;
+	t->done = done;
+	t->context = context;
+	return SPI_submit(t);
+}
+
+// writes nbytes registers from address on in one transaction
+int SPI_writeAsync(SPI_transaction *t, uint8_t address, const uint8_t *data, int nbytes, SPI_callback done, void *context) {
+	t->command = address & 0x7F;
+	t->tx = data;
+	t->rx = 0;
+	t->length = (uint16_t) nbytes;
+	t->done = done;
+	t->context = context;
+	return SPI_submit(t);
+}
+
+// transactions queued or running
+int SPI_pending(void) {
+	return (int) (spi_head - spi_tail);
+}
+
+// running transaction, NULL if queue is empty
+SPI_transaction *SPI_active(void) {
+	if (spi_head == spi_tail)
+		return 0;
+	return spi_queue[spi_tail & (SPI_QUEUE_SIZE - 1)];
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,242 @@
+/*----------------------------------------------------------------------------
+* Filename:         ece_spi_host.c
+* Description:      Linux check of asynchronous SPI queue against loopback
+*                   stand-in for SSP0, submits and completes transactions in
+*                   random interleavings, some resubmitted from their own
+*                   callback, and checks they finish in order with right
+*                   bytes, not part of board image
+*                   build: gcc -I. -Ihost -o ece_spi_host ece_spi_host.c
+*                          ece_spi_async.c host/ece_spi_loopback.c
+*                   run:   ece_spi_host [transactions] [seed]
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ece_spi.h"
+#include "ece_spi_loopback.h"
+
+/*----------------------------------------------------------------------------
+ *      Check Constants
+ *---------------------------------------------------------------------------*/
+
+#define DEFAULT_TRANSACTIONS    20000
+// more slots than queue holds so a full queue is reached
+#define SLOTS                   (SPI_QUEUE_SIZE + 4)
+#define LENGTH_MAX              48
+// bytes past end of rx that must never be written
+#define GUARD                   8
+#define GUARD_BYTE              0xEE
+// one callback in this many submits a follow-up read from interrupt
+#define CHAIN_EVERY             5
+
+/*----------------------------------------------------------------------------
+ *      Check Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    SPI_transaction t;
+    uint32_t seq;
+    uint8_t tx[LENGTH_MAX];
+    uint8_t rx[LENGTH_MAX + GUARD];
+    uint8_t in_use;
+} Slot;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+static Slot     slots[SLOTS];
+// sequence given to next submit, and expected at next callback
+static uint32_t next_seq = 0;
+static uint32_t done_seq = 0;
+static uint32_t errors = 0;
+static uint32_t chained = 0;
+static uint32_t full = 0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      fail
+*   Author(s):          George Cowan
+*   Definition:         reports a failed check, first few only
+*   Parameters:         message, sequence number it concerns
+*******************************************************************************/
+static void fail(const char *message, uint32_t seq) {
+    if (errors < 10) {
+        printf("seq %u: %s\n", seq, message);
+    }
+    ++errors;
+}
+
+/*******************************************************************************
+*   Function Name:      fill
+*   Author(s):          George Cowan
+*   Definition:         sets up slot as a random transaction, writes, reads
+                        and exchanges with or without buffers
+*   Parameters:         slot (modified)
+*******************************************************************************/
+static void fill(Slot *s) {
+    uint8_t i,
+            kind = rand() % 4;
+
+    s->seq = next_seq++;
+    s->t.command = (uint8_t) s->seq;
+    s->t.length = rand() % (LENGTH_MAX + 1);
+    for (i = 0; i < LENGTH_MAX; ++i) {
+        s->tx[i] = (uint8_t) (s->seq * 7 + i * 13 + 1);
+    }
+    memset(s->rx, GUARD_BYTE, sizeof(s->rx));
+    // 0 exchange, 1 read (zeros sent), 2 write (nothing kept), 3 both null
+    s->t.tx = (kind == 0 || kind == 2) ? s->tx : NULL;
+    s->t.rx = (kind == 0 || kind == 1) ? s->rx : NULL;
+}
+
+/*******************************************************************************
+*   Function Name:      check
+*   Author(s):          George Cowan
+*   Definition:         checks slot finished next in order, with loopback of
+                        its own bytes and nothing written past its length
+*   Parameters:         slot
+*******************************************************************************/
+static void check(const Slot *s) {
+    uint16_t i;
+    uint8_t expected;
+
+    if (s->seq != done_seq) {
+        fail("finished out of order", s->seq);
+    }
+    done_seq = s->seq + 1;
+
+    if (s->t.status != SPI_DONE) {
+        fail("status not done", s->seq);
+    }
+    for (i = 0; i < LENGTH_MAX + GUARD; ++i) {
+        expected = GUARD_BYTE;
+        if (s->t.rx != NULL && i < s->t.length) {
+            expected = (s->t.tx != NULL) ? s->tx[i] : 0;
+        }
+        if (s->rx[i] != expected) {
+            fail("received bytes wrong", s->seq);
+            break;
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      on_done
+*   Author(s):          George Cowan
+*   Definition:         completion callback, runs where DMA interrupt would,
+                        checks slot and sometimes resubmits it at once as a
+                        sensor poll would
+*   Parameters:         slot
+*******************************************************************************/
+static void on_done(void *context) {
+    Slot *s = (Slot *) context;
+
+    check(s);
+
+    if ((rand() % CHAIN_EVERY) == 0) {
+        fill(s);
+        if (SPI_submit(&s->t)) {
+            ++chained;
+            return;
+        }
+        // queue full, sequence number is given back unused
+        --next_seq;
+    }
+    s->in_use = 0;
+}
+
+/*******************************************************************************
+*   Function Name:      submit
+*   Author(s):          George Cowan
+*   Definition:         submits a random transaction from a free slot, checks
+                        queue refuses exactly when full and refuses a
+                        transaction already queued
+*   Parameters:         slot (modified)
+*******************************************************************************/
+static void submit(Slot *s) {
+    int pending = SPI_pending();
+
+    fill(s);
+    s->t.done = on_done;
+    s->t.context = s;
+    s->t.status = SPI_IDLE;
+
+    if (!SPI_submit(&s->t)) {
+        if (pending < SPI_QUEUE_SIZE) {
+            fail("refused with room in queue", s->seq);
+        }
+        --next_seq;
+        ++full;
+        return;
+    }
+    if (pending >= SPI_QUEUE_SIZE) {
+        fail("accepted past full queue", s->seq);
+    }
+    if (SPI_submit(&s->t)) {
+        fail("accepted twice", s->seq);
+    }
+    s->in_use = 1;
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         runs random submits and completions until count is
+                        reached, then drains queue
+*   Parameters:         transactions to finish, random seed
+*   Returns:            0 if every check passed
+*******************************************************************************/
+int main(int argc, char **argv) {
+    uint32_t total = (argc > 1) ? (uint32_t) atoi(argv[1]) : DEFAULT_TRANSACTIONS;
+    uint8_t i;
+    int result;
+
+    srand((argc > 2) ? (unsigned) atoi(argv[2]) : 1);
+    SPI_asyncSetup();
+
+    while (next_seq < total) {
+        // submits outpace completions so queue often fills
+        if (rand() % 3 != 0) {
+            i = rand() % SLOTS;
+            if (!slots[i].in_use) {
+                submit(&slots[i]);
+            }
+        }
+        else if (SPI_loopbackComplete() < 0) {
+            fail("chip select not held", done_seq);
+        }
+    }
+    while ((result = SPI_loopbackComplete()) > 0) {
+    }
+    if (result < 0) {
+        fail("chip select not held", done_seq);
+    }
+
+    if (done_seq != next_seq) {
+        fail("transactions left unfinished", done_seq);
+    }
+    if (SPI_pending() != 0 || SPI_loopbackSelected) {
+        fail("bus not idle at end", done_seq);
+    }
+    for (i = 0; i < SLOTS; ++i) {
+        if (slots[i].in_use) {
+            fail("slot never called back", slots[i].seq);
+        }
+    }
+
+    printf("transactions %u chained %u refused full %u errors %u %s\n",
+           done_seq, chained, full, errors, errors == 0 ? "ok" : "FAILED");
+
+    return errors == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
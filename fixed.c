@@ -0,0 +1,119 @@
+/*----------------------------------------------------------------------------
+* Filename:         fixed.c
+* Description:      Q16.16 fixed point math for pong physics on Keil MCB1700
+*                   board, LPC1768 has no FPU
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "fixed.h"
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      fixed_div
+*   Author(s):          George Cowan
+*   Definition:         divides two integers into a fixed point fraction,
+                        rounded towards negative infinity so fixed_floor of
+                        the result is the exact floor of num / den
+                        num must be less than 32768 in magnitude
+*   Parameters:         numerator, denominator
+*   Returns:            num / den in Q16.16, 0 if den is 0
+*******************************************************************************/
+fixed_t fixed_div(int32_t num, int32_t den) {
+    fixed_t q,
+            r;
+
+    if (den == 0) {
+        return 0;
+    }
+
+    q = FIXED_FROM_INT(num) / den;
+    r = FIXED_FROM_INT(num) % den;
+
+    // C division truncates towards zero
+    if (r != 0 && ((r < 0) != (den < 0))) {
+        --q;
+    }
+
+    return q;
+}
+
+/*******************************************************************************
+*   Function Name:      fixed_floor
+*   Author(s):          George Cowan
+*   Definition:         largest integer not greater than fixed point value
+*   Parameters:         fixed point value
+*   Returns:            floor of value
+*******************************************************************************/
+int32_t fixed_floor(fixed_t a) {
+    // arithmetic shift rounds towards negative infinity
+    return a >> FIXED_SHIFT;
+}
+
+/*******************************************************************************
+*   Function Name:      fixed_ceil
+*   Author(s):          George Cowan
+*   Definition:         smallest integer not less than fixed point value
+*   Parameters:         fixed point value
+*   Returns:            ceiling of value
+*******************************************************************************/
+int32_t fixed_ceil(fixed_t a) {
+    return (a + (FIXED_ONE - 1)) >> FIXED_SHIFT;
+}
+
+/*******************************************************************************
+*   Function Name:      fixed_trunc
+*   Author(s):          George Cowan
+*   Definition:         integer part of fixed point value, rounded towards
+                        zero
+*   Parameters:         fixed point value
+*   Returns:            value without fraction
+*******************************************************************************/
+int32_t fixed_trunc(fixed_t a) {
+    return (a < 0) ? -fixed_floor(-a) : fixed_floor(a);
+}
+
+/*******************************************************************************
+*   Function Name:      fixed_mul
+*   Author(s):          George Cowan
+*   Definition:         multiplies two fixed point values, rounded towards
+                        negative infinity
+*   Parameters:         fixed point values
+*   Returns:            a * b in Q16.16
+*******************************************************************************/
+fixed_t fixed_mul(fixed_t a, fixed_t b) {
+    return (fixed_t) (((int64_t) a * b) >> FIXED_SHIFT);
+}
+
+/*******************************************************************************
+*   Function Name:      fixed_isqrt
+*   Author(s):          George Cowan
+*   Definition:         integer square root, one result bit per step so
+                        always 16 iterations
+*   Parameters:         value
+*   Returns:            floor of square root of value
+*******************************************************************************/
+uint32_t fixed_isqrt(uint32_t a) {
+    uint32_t root = 0,
+             bit = 1ul << 30;
+
+    while (bit != 0) {
+        if (a >= root + bit) {
+            a -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,29 @@
+/*----------------------------------------------------------------------------
+* Filename:         fixed.h
+* Description:      Q16.16 fixed point math for pong physics on Keil MCB1700
+*                   board, LPC1768 has no FPU
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _FIXED_H
+#define _FIXED_H
+
+// signed Q16.16, 16 integer bits and 16 fraction bits
+typedef int32_t fixed_t;
+
+#define FIXED_SHIFT             16
+#define FIXED_ONE               ((fixed_t) 1 << FIXED_SHIFT)
+#define FIXED_FROM_INT(i)       ((fixed_t) (i) * FIXED_ONE)
+
+fixed_t     fixed_div       (int32_t num, int32_t den);
+int32_t     fixed_floor     (fixed_t a);
+int32_t     fixed_ceil      (fixed_t a);
+int32_t     fixed_trunc     (fixed_t a);
+fixed_t     fixed_mul       (fixed_t a, fixed_t b);
+uint32_t    fixed_isqrt     (uint32_t a);
+
+#endif /* _FIXED_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
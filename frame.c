@@ -0,0 +1,667 @@
+/*----------------------------------------------------------------------------
+* Filename:         frame.c
+* Description:      Per-frame dirty region compositor for LCD drawing in pong
+*                   on Keil MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "GLCD.h"
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "frame.h"
+#include "prof.h"
+
+/*----------------------------------------------------------------------------
+ *      Frame Constants
+ *---------------------------------------------------------------------------*/
+
+#define FRAME_MAX_DIRTY         64
+#define FRAME_MAX_PENDING       16
+// window setup on LCD bus costs about as much as this many pixels
+#define FRAME_WINDOW_COST       16
+#define FRAME_MAX_RECTS         8
+// one full LCD row, regions narrower than this are sent several rows a burst
+#define FRAME_BUFFER_PIXELS     320
+
+const uint16_t          LCD_MAX_X               =     319;
+const uint16_t          LCD_MAX_Y               =     239;
+const unsigned short    FRAME_BACKGROUND        =     Black;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+// scene layers, composited back to front in order added
+static Rect            *rect_layers[FRAME_MAX_RECTS];
+static uint8_t          rect_layer_count        =     0;
+// brick grid, composited above rectangles and below balls, NULL if none
+static Bricks          *brick_layer             =     NULL;
+// ball set, composited above bricks, NULL if none
+static BallSet         *set_layer               =     NULL;
+
+// balls of set layer overlapping region being composited
+static uint8_t          set_hits[BALL_SET_MAX];
+static uint8_t          set_hit_count           =     0;
+
+// regions reported this frame, kept non-overlapping
+static Rect             dirty[FRAME_MAX_DIRTY];
+static uint8_t          dirty_count             =     0;
+
+static unsigned short   frame_buffer[FRAME_BUFFER_PIXELS];
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      frame_add_rect
+*   Author(s):          Alexander Rathke
+*   Definition:         adds rectangle to scene, composited above earlier layers
+*   Parameters:         rectangle, must stay valid while frames are flushed
+*******************************************************************************/
+void frame_add_rect(Rect *r) {
+    if (rect_layer_count < FRAME_MAX_RECTS) {
+        rect_layers[rect_layer_count++] = r;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      frame_add_bricks
+*   Author(s):          Alexander Rathke
+*   Definition:         adds brick grid to scene, composited above all
+                        rectangles and below balls
+*   Parameters:         bricks, must stay valid while frames are flushed
+*******************************************************************************/
+void frame_add_bricks(Bricks *k) {
+    brick_layer = k;
+}
+
+/*******************************************************************************
+*   Function Name:      frame_add_ball_set
+*   Author(s):          Alexander Rathke
+*   Definition:         adds set of balls to scene, composited above all
+                        rectangles and bricks, replaces any set added before
+*   Parameters:         ball set, must stay valid while frames are flushed
+*******************************************************************************/
+void frame_add_ball_set(BallSet *s) {
+    set_layer = s;
+}
+
+/*******************************************************************************
+*   Function Name:      regions_overlap
+*   Author(s):          Alexander Rathke
+*   Definition:         checks if two regions share any pixel
+*   Parameters:         region a, region b
+*   Returns:            true if regions overlap, false otherwise
+*******************************************************************************/
+static bool regions_overlap(Rect *a, Rect *b) {
+    return (a->b_left.x <= b->t_right.x && b->b_left.x <= a->t_right.x &&
+            a->b_left.y <= b->t_right.y && b->b_left.y <= a->t_right.y);
+}
+
+/*******************************************************************************
+*   Function Name:      regions_touch
+*   Author(s):          Alexander Rathke
+*   Definition:         checks if two regions overlap or share an edge
+*   Parameters:         region a, region b
+*   Returns:            true if regions overlap or are adjacent, false
+                        otherwise
+*******************************************************************************/
+static bool regions_touch(Rect *a, Rect *b) {
+    return (a->b_left.x <= b->t_right.x + 1 && b->b_left.x <= a->t_right.x + 1 &&
+            a->b_left.y <= b->t_right.y + 1 && b->b_left.y <= a->t_right.y + 1);
+}
+
+/*******************************************************************************
+*   Function Name:      region_union
+*   Author(s):          Alexander Rathke
+*   Definition:         grows region a to bounding box of regions a and b
+*   Parameters:         region a (modified), region b
+*******************************************************************************/
+static void region_union(Rect *a, Rect *b) {
+    if (b->b_left.x < a->b_left.x) {
+        a->b_left.x = b->b_left.x;
+    }
+    if (b->b_left.y < a->b_left.y) {
+        a->b_left.y = b->b_left.y;
+    }
+    if (b->t_right.x > a->t_right.x) {
+        a->t_right.x = b->t_right.x;
+    }
+    if (b->t_right.y > a->t_right.y) {
+        a->t_right.y = b->t_right.y;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      region_area
+*   Author(s):          Alexander Rathke
+*   Definition:         number of pixels covered by region
+*   Parameters:         region
+*   Returns:            area of region in pixels
+*******************************************************************************/
+static uint32_t region_area(Rect *r) {
+    return (uint32_t) (r->t_right.x - r->b_left.x + 1) * (r->t_right.y - r->b_left.y + 1);
+}
+
+/*******************************************************************************
+*   Function Name:      merge_is_cheaper
+*   Author(s):          Alexander Rathke
+*   Definition:         checks if sending bounding box of two regions costs
+                        no more than sending them separately, counting setup
+                        of an extra window as slack pixels
+*   Parameters:         region a, region b, extra pixels a merge may send
+*   Returns:            true if regions should be merged, false otherwise
+*******************************************************************************/
+static bool merge_is_cheaper(Rect *a, Rect *b, uint16_t slack) {
+    Rect bounds = *a;
+    region_union(&bounds, b);
+    return (region_area(&bounds) <= region_area(a) + region_area(b) + slack);
+}
+
+/*******************************************************************************
+*   Function Name:      region_carve
+*   Author(s):          Alexander Rathke
+*   Definition:         splits region into up to four pieces not overlapping
+                        hole: rows before hole, rows after hole, and parts
+                        left and right of hole in rows shared with it
+*   Parameters:         region, overlapping hole, array to append pieces to
+*   Returns:            number of pieces appended
+*******************************************************************************/
+static uint8_t region_carve(Rect *r, Rect *hole, Rect *out) {
+    uint8_t n = 0;
+    uint16_t y0 = (r->b_left.y > hole->b_left.y) ? r->b_left.y : hole->b_left.y,
+             y1 = (r->t_right.y < hole->t_right.y) ? r->t_right.y : hole->t_right.y;
+
+    if (r->b_left.y < hole->b_left.y) {
+        out[n++] = new_rect(r->b_left, new_point(r->t_right.x, hole->b_left.y - 1), FRAME_BACKGROUND);
+    }
+    if (r->t_right.y > hole->t_right.y) {
+        out[n++] = new_rect(new_point(r->b_left.x, hole->t_right.y + 1), r->t_right, FRAME_BACKGROUND);
+    }
+    if (r->b_left.x < hole->b_left.x) {
+        out[n++] = new_rect(new_point(r->b_left.x, y0), new_point(hole->b_left.x - 1, y1), FRAME_BACKGROUND);
+    }
+    if (r->t_right.x > hole->t_right.x) {
+        out[n++] = new_rect(new_point(hole->t_right.x + 1, y0), new_point(r->t_right.x, y1), FRAME_BACKGROUND);
+    }
+    return n;
+}
+
+/*******************************************************************************
+*   Function Name:      mark_region
+*   Author(s):          Alexander Rathke
+*   Definition:         reports region to be repainted on next flush, list is
+                        kept non-overlapping so no pixel is sent twice
+                        region is first merged with overlapping or adjacent
+                        regions where bounding box sends no more than slack
+                        pixels beyond both together, then carved around any
+                        it still overlaps
+                        when list or carve stack is full remaining pieces
+                        are merged instead
+*   Parameters:         bottom left and top right corners of region, extra
+                        pixels a merge may send
+*******************************************************************************/
+static void mark_region(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t slack) {
+    static Rect pending[FRAME_MAX_PENDING];
+    Rect region;
+    uint8_t pending_count = 0,
+            i;
+    bool carved,
+         merge_only = false;
+
+    if (x1 > LCD_MAX_X) {
+        x1 = LCD_MAX_X;
+    }
+    if (y1 > LCD_MAX_Y) {
+        y1 = LCD_MAX_Y;
+    }
+    if (x0 > x1 || y0 > y1) {
+        return;
+    }
+
+    region = new_rect(new_point(x0, y0), new_point(x1, y1), FRAME_BACKGROUND);
+
+    i = 0;
+    while (i < dirty_count) {
+        if (regions_touch(&region, &dirty[i]) && merge_is_cheaper(&region, &dirty[i], slack)) {
+            region_union(&region, &dirty[i]);
+            dirty[i] = dirty[--dirty_count];
+            // grown region may now overlap one already checked
+            i = 0;
+        }
+        else {
+            ++i;
+        }
+    }
+
+    pending[pending_count++] = region;
+
+    while (pending_count > 0) {
+        region = pending[--pending_count];
+        carved = false;
+
+        i = 0;
+        while (i < dirty_count) {
+            if (!regions_overlap(&region, &dirty[i])) {
+                ++i;
+            }
+            else if (merge_only || pending_count + 4 > FRAME_MAX_PENDING) {
+                merge_only = true;
+                region_union(&region, &dirty[i]);
+                dirty[i] = dirty[--dirty_count];
+                i = 0;
+            }
+            else {
+                pending_count += region_carve(&region, &dirty[i], &pending[pending_count]);
+                carved = true;
+                break;
+            }
+        }
+
+        if (!carved) {
+            if (dirty_count < FRAME_MAX_DIRTY) {
+                dirty[dirty_count++] = region;
+            }
+            else {
+                // list full, fold into last entry and check result again
+                merge_only = true;
+                region_union(&region, &dirty[--dirty_count]);
+                pending[pending_count++] = region;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      frame_mark_dirty
+*   Author(s):          Alexander Rathke
+*   Definition:         reports region to be repainted on next flush, merged
+                        with neighbors where saving a window setup is worth
+                        the extra pixels sent
+                        caller must hold LCD draw mutex
+*   Parameters:         bottom left and top right corners of region
+*******************************************************************************/
+void frame_mark_dirty(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    mark_region(x0, y0, x1, y1, FRAME_WINDOW_COST);
+}
+
+/*******************************************************************************
+*   Function Name:      frame_mark_rect
+*   Author(s):          Alexander Rathke
+*   Definition:         reports area covered by rectangle as dirty
+*   Parameters:         rectangle
+*******************************************************************************/
+void frame_mark_rect(Rect *r) {
+    frame_mark_dirty(r->b_left.x, r->b_left.y, r->t_right.x, r->t_right.y);
+}
+
+/*******************************************************************************
+*   Function Name:      frame_mark_circle
+*   Author(s):          Alexander Rathke
+*   Definition:         reports lit row spans of a ball drawn from shared
+                        circle tables as dirty, or bounding box if radius
+                        has no table
+*   Parameters:         center x and y, radius
+*******************************************************************************/
+void frame_mark_circle(uint16_t x, uint16_t y, uint16_t radius) {
+    const Span *spans = ball_spans(radius);
+    uint16_t row,
+             dim = (2 * radius) + 1,
+             x0 = x - radius,
+             y0 = y - radius;
+
+    if (spans == NULL) {
+        frame_mark_dirty(x0, y0, x0 + dim - 1, y0 + dim - 1);
+        return;
+    }
+
+    for (row = 0; row < dim; ++row) {
+        frame_mark_dirty(x0 + spans[row].start, y0 + row,
+                         x0 + spans[row].start + spans[row].length - 1, y0 + row);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      box_misses_circle
+*   Author(s):          Alexander Rathke
+*   Definition:         checks box covers no lit pixel of a ball drawn from
+                        shared circle tables
+*   Parameters:         box, ball row spans, ball bounding box left and top,
+                        ball size
+*   Returns:            true if box and ball share no pixel
+*******************************************************************************/
+static bool box_misses_circle(Rect *box, const Span *spans, int16_t x0, int16_t y0, int16_t dim) {
+    int16_t y,
+            top = (box->b_left.y > y0) ? box->b_left.y : y0,
+            bottom = (box->t_right.y < y0 + dim - 1) ? box->t_right.y : (y0 + dim - 1);
+
+    for (y = top; y <= bottom; ++y) {
+        if (box->b_left.x <= x0 + spans[y - y0].start + spans[y - y0].length - 1 &&
+            x0 + spans[y - y0].start <= box->t_right.x) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*******************************************************************************
+*   Function Name:      grow_box
+*   Author(s):          Alexander Rathke
+*   Definition:         adds a row piece to a box of moved ball pieces if
+                        that sends no more than FRAME_WINDOW_COST extra
+                        pixels and, for clear boxes, covers no new ball
+                        pixel, otherwise reports box as dirty and restarts
+                        it at piece
+*   Parameters:         box, true if box is open (modified), piece start and
+                        end x, row, new ball row spans, left and top and size
+                        (spans NULL for draw box)
+*******************************************************************************/
+static void grow_box(Rect *box, bool *open, int16_t lo, int16_t hi, int16_t y,
+                     const Span *spans, int16_t x0, int16_t y0, int16_t dim) {
+    Rect grown;
+
+    if (*open) {
+        grown = *box;
+        if (lo < grown.b_left.x) {
+            grown.b_left.x = lo;
+        }
+        if (hi > grown.t_right.x) {
+            grown.t_right.x = hi;
+        }
+        grown.t_right.y = y;
+        if (region_area(&grown) <= region_area(box) + (hi - lo + 1) + FRAME_WINDOW_COST &&
+            (spans == NULL || box_misses_circle(&grown, spans, x0, y0, dim))) {
+            *box = grown;
+            return;
+        }
+        mark_region(box->b_left.x, box->b_left.y, box->t_right.x, box->t_right.y, 0);
+    }
+    *box = new_rect(new_point(lo, y), new_point(hi, y), FRAME_BACKGROUND);
+    *open = true;
+}
+
+/*******************************************************************************
+*   Function Name:      frame_mark_circle_move
+*   Author(s):          Alexander Rathke
+*   Definition:         reports pixels a moved ball drawn from shared circle
+                        tables changes as dirty, per row the part of old
+                        span not covered by new span is cleared and new
+                        span is drawn
+                        new spans are gathered into one box and cleared
+                        pieces into one box per side while each row added
+                        saves a window setup for no more than
+                        FRAME_WINDOW_COST extra pixels, clear boxes never
+                        reach into new ball so gap between old and new
+                        spans is not sent
+                        if dirty list might not hold every piece they are
+                        reported as other regions are instead
+*   Parameters:         old center x and y, new center x and y, radius
+*******************************************************************************/
+void frame_mark_circle_move(uint16_t old_x, uint16_t old_y, uint16_t new_x, uint16_t new_y, uint16_t radius) {
+    const Span *spans = ball_spans(radius);
+    int16_t y,
+            dim = (2 * radius) + 1,
+            old_left = old_x - radius,
+            new_left = new_x - radius,
+            old_top = old_y - radius,
+            new_top = new_y - radius,
+            top = (old_top < new_top) ? old_top : new_top,
+            bottom = ((old_top > new_top) ? old_top : new_top) + dim - 1,
+            old_lo,
+            old_hi,
+            new_lo = 0,
+            new_hi = 0;
+    Rect box[3];
+    bool open[3] = { false, false, false },
+         new_lit;
+    uint8_t side;
+
+    if (spans == NULL) {
+        frame_mark_circle(old_x, old_y, radius);
+        frame_mark_circle(new_x, new_y, radius);
+        return;
+    }
+    // at most three pieces per row
+    if (dirty_count + (6 * dim) > FRAME_MAX_DIRTY) {
+        frame_mark_circle(old_x, old_y, radius);
+        frame_mark_circle(new_x, new_y, radius);
+        return;
+    }
+
+    for (y = top; y <= bottom; ++y) {
+        new_lit = (y >= new_top && y < new_top + dim);
+        if (new_lit) {
+            new_lo = new_left + spans[y - new_top].start;
+            new_hi = new_lo + spans[y - new_top].length - 1;
+            grow_box(&box[2], &open[2], new_lo, new_hi, y, NULL, 0, 0, 0);
+        }
+        if (y < old_top || y >= old_top + dim) {
+            continue;
+        }
+        old_lo = old_left + spans[y - old_top].start;
+        old_hi = old_lo + spans[y - old_top].length - 1;
+
+        // old span split by new one into left and right pieces, a row new
+        // ball misses joins left box unless only right one is open
+        if (new_lit && old_lo <= new_hi && new_lo <= old_hi) {
+            if (old_lo < new_lo) {
+                grow_box(&box[0], &open[0], old_lo, new_lo - 1, y, spans, new_left, new_top, dim);
+            }
+            if (old_hi > new_hi) {
+                grow_box(&box[1], &open[1], new_hi + 1, old_hi, y, spans, new_left, new_top, dim);
+            }
+        }
+        else {
+            side = new_lit ? (old_lo > new_hi) : (open[1] && !open[0]);
+            grow_box(&box[side], &open[side], old_lo, old_hi, y, spans, new_left, new_top, dim);
+        }
+    }
+
+    for (side = 0; side < 3; ++side) {
+        if (open[side]) {
+            mark_region(box[side].b_left.x, box[side].b_left.y, box[side].t_right.x, box[side].t_right.y, 0);
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      frame_mark_bricks
+*   Author(s):          Alexander Rathke
+*   Definition:         reports cells of brick grid marked changed as dirty,
+                        one region per run of changed cells in a row, and
+                        clears changed marks, words with no change are
+                        skipped whole
+*   Parameters:         bricks (changed marks cleared)
+*******************************************************************************/
+void frame_mark_bricks(Bricks *k) {
+    uint32_t bits;
+    uint16_t w,
+             n,
+             cx,
+             cy,
+             len;
+    uint8_t b;
+
+    for (w = 0; w < BRICK_WORDS; ++w) {
+        bits = k->changed[w];
+        k->changed[w] = 0;
+        b = 0;
+        while (bits != 0) {
+            if (!(bits & 1u)) {
+                bits >>= 1;
+                ++b;
+                continue;
+            }
+
+            n = (w << 5) + b;
+            cx = n % BRICK_COLS;
+            cy = n / BRICK_COLS;
+            // run ends at end of word or end of row
+            len = 0;
+            while ((bits & 1u) && cx + len < BRICK_COLS) {
+                bits >>= 1;
+                ++b;
+                ++len;
+            }
+            frame_mark_dirty(cx << BRICK_SHIFT, cy << BRICK_SHIFT,
+                             ((cx + len) << BRICK_SHIFT) - 1, ((cy + 1) << BRICK_SHIFT) - 1);
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      find_set_hits
+*   Author(s):          Alexander Rathke
+*   Definition:         lists balls of set layer whose bounding box overlaps
+                        region, so rows of region only test those balls
+*   Parameters:         region
+*******************************************************************************/
+static void find_set_hits(Rect *region) {
+    uint8_t i;
+    uint16_t r;
+
+    set_hit_count = 0;
+    if (set_layer == NULL) {
+        return;
+    }
+
+    for (i = 0; i < set_layer->count; ++i) {
+        r = set_layer->radius[i];
+        if (set_layer->x[i] + r >= region->b_left.x && set_layer->x[i] <= region->t_right.x + r &&
+            set_layer->y[i] + r >= region->b_left.y && set_layer->y[i] <= region->t_right.y + r) {
+            set_hits[set_hit_count++] = i;
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      compose_row
+*   Author(s):          Alexander Rathke
+*   Definition:         composites all scene layers for one row segment into
+                        pixel buffer
+*   Parameters:         buffer, row y, first and last x of segment
+*******************************************************************************/
+static void compose_row(unsigned short *row, uint16_t y, uint16_t x0, uint16_t x1) {
+    uint16_t i, x, lo, hi, mask_row, cx, cy, radius, last;
+    const uint16_t *mask;
+    Rect *r;
+
+    for (x = x0; x <= x1; ++x) {
+        row[x - x0] = FRAME_BACKGROUND;
+    }
+
+    for (i = 0; i < rect_layer_count; ++i) {
+        r = rect_layers[i];
+        lo = (r->b_left.x > x0) ? r->b_left.x : x0;
+        hi = (r->t_right.x < x1) ? r->t_right.x : x1;
+        if (y < r->b_left.y || y > r->t_right.y || lo > hi) {
+            continue;
+        }
+        for (x = lo; x <= hi; ++x) {
+            row[x - x0] = r->color;
+        }
+    }
+
+    // last row and column of each cell is gap between bricks
+    if (brick_layer != NULL && brick_layer->count > 0 && (y & (BRICK_SIZE - 1)) != BRICK_SIZE - 1) {
+        cy = y >> BRICK_SHIFT;
+        last = x1 >> BRICK_SHIFT;
+        for (cx = x0 >> BRICK_SHIFT; cx <= last; ++cx) {
+            if (!BRICK_BIT(brick_layer->cells, BRICK_INDEX(cx, cy))) {
+                continue;
+            }
+            lo = ((cx << BRICK_SHIFT) > x0) ? (cx << BRICK_SHIFT) : x0;
+            hi = ((cx << BRICK_SHIFT) + BRICK_SIZE - 2 < x1) ? (cx << BRICK_SHIFT) + BRICK_SIZE - 2 : x1;
+            for (x = lo; x <= hi; ++x) {
+                row[x - x0] = brick_layer->color;
+            }
+        }
+    }
+
+    for (i = 0; i < set_hit_count; ++i) {
+        cx = set_layer->x[set_hits[i]];
+        cy = set_layer->y[set_hits[i]];
+        radius = set_layer->radius[set_hits[i]];
+        mask = ball_mask(radius);
+        lo = (cx - radius > x0) ? cx - radius : x0;
+        hi = (cx + radius < x1) ? cx + radius : x1;
+        if (mask == NULL || y + radius < cy || y > cy + radius || lo > hi) {
+            continue;
+        }
+        mask_row = mask[y + radius - cy];
+        for (x = lo; x <= hi; ++x) {
+            if (mask_row & (1u << (x + radius - cx))) {
+                row[x - x0] = set_layer->color;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      frame_flush
+*   Author(s):          Alexander Rathke
+*   Definition:         repaints all dirty regions in scan order, each pixel
+                        composited once from scene layers, then clears list
+                        caller must hold LCD draw mutex
+*******************************************************************************/
+void frame_flush(void) {
+    uint8_t i, j;
+    uint16_t y, w, rows, rows_per_burst;
+    Rect region;
+    uint32_t prof_start,
+             prof_part;
+
+    PROF_BEGIN(prof_start);
+
+    // insertion sort into scan order (top row first, then left to right)
+    for (i = 1; i < dirty_count; ++i) {
+        region = dirty[i];
+        j = i;
+        while (j > 0 && (dirty[j-1].b_left.y > region.b_left.y ||
+                        (dirty[j-1].b_left.y == region.b_left.y &&
+                         dirty[j-1].b_left.x > region.b_left.x))) {
+            dirty[j] = dirty[j-1];
+            --j;
+        }
+        dirty[j] = region;
+    }
+
+    for (i = 0; i < dirty_count; ++i) {
+        w = dirty[i].t_right.x - dirty[i].b_left.x + 1;
+        rows_per_burst = (w >= FRAME_BUFFER_PIXELS) ? 1 : (FRAME_BUFFER_PIXELS / w);
+        find_set_hits(&dirty[i]);
+
+        for (y = dirty[i].b_left.y; y <= dirty[i].t_right.y; y += rows) {
+            rows = dirty[i].t_right.y - y + 1;
+            if (rows > rows_per_burst) {
+                rows = rows_per_burst;
+            }
+            PROF_BEGIN(prof_part);
+            for (j = 0; j < rows; ++j) {
+                compose_row(&frame_buffer[j * w], y + j, dirty[i].b_left.x, dirty[i].t_right.x);
+            }
+            PROF_END(PROF_FRAME_COMPOSE, prof_part);
+
+            PROF_BEGIN(prof_part);
+            sprite_blit(dirty[i].b_left.x, y, w, rows, frame_buffer);
+            PROF_END(PROF_FRAME_BLIT, prof_part);
+        }
+    }
+
+    dirty_count = 0;
+
+    PROF_END(PROF_FRAME_FLUSH, prof_start);
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
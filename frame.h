@@ -0,0 +1,26 @@
+/*----------------------------------------------------------------------------
+* Filename:         frame.h
+* Description:      Per-frame dirty region compositor for LCD drawing in pong
+*                   on Keil MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _FRAME_H
+#define _FRAME_H
+
+void    frame_add_rect      (Rect *r);
+void    frame_add_bricks    (Bricks *k);
+void    frame_add_ball_set  (BallSet *s);
+void    frame_mark_dirty    (uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void    frame_mark_rect     (Rect *r);
+void    frame_mark_circle   (uint16_t x, uint16_t y, uint16_t radius);
+void    frame_mark_circle_move(uint16_t old_x, uint16_t old_y, uint16_t new_x, uint16_t new_y,
+                               uint16_t radius);
+void    frame_mark_bricks   (Bricks *k);
+void    frame_flush         (void);
+
+#endif /* _FRAME_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
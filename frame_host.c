@@ -0,0 +1,288 @@
+/*----------------------------------------------------------------------------
+* Filename:         frame_host.c
+* Description:      Linux check of per-frame dirty list compositor, moves a
+*                   ball and paddle through scripted scenes and counts LCD
+*                   pixels and bus transactions per frame drawn as objects
+*                   were drawn before compositing (each erased and redrawn
+*                   on its own) against frame_flush, and checks screen after
+*                   every flush against layers painted directly, not part of
+*                   board image
+*                   build: gcc -Ihost -o frame_host frame_host.c frame.c
+*                          sprite.c ball.c rect.c point.c utils.c prof.c
+*                          host/glcd_host.c
+*                   run:   frame_host
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "GLCD.h"
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "frame.h"
+
+/*----------------------------------------------------------------------------
+ *      Check Constants
+ *---------------------------------------------------------------------------*/
+
+#define FRAMES                  40
+#define BORDER_WIDTH            10
+#define PADDLE_X0               15
+#define PADDLE_X1               25
+#define PADDLE_Y0               93
+#define PADDLE_WIDTH            52
+
+/*----------------------------------------------------------------------------
+ *      Check Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    const char *name;
+    // ball start and step per frame, paddle step per frame
+    uint16_t x, y;
+    int16_t vx, vy;
+    int16_t paddle_vy;
+} Scene;
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t pixels;
+} Cost;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+static const Scene SCENES[] = {
+    // ball beside bottom paddle, both moving
+    { "beside paddle",  40,  60,  0,  3,  2 },
+    // ball passing over paddle while it moves
+    { "over paddle",    20,  60,  0,  3,  2 },
+    // ball crossing open field, paddle still
+    { "open field",     80,  60,  3,  2,  0 },
+    // paddle moving alone, ball still
+    { "paddle only",   160, 120,  0,  0,  2 }
+};
+
+static Rect             border_left;
+static Rect             border_right;
+static Rect             paddle;
+static Ball             ball;
+// ball as compositor sees it, same position as ball
+static BallSet          ball_set;
+static unsigned short   expected[HEIGHT][WIDTH];
+static uint32_t         errors = 0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      paint_rect
+*   Author(s):          George Cowan
+*   Definition:         paints rectangle into expected screen
+*   Parameters:         rectangle
+*******************************************************************************/
+static void paint_rect(Rect *r) {
+    uint16_t x, y;
+
+    for (y = r->b_left.y; y <= r->t_right.y; ++y) {
+        for (x = r->b_left.x; x <= r->t_right.x; ++x) {
+            expected[y][x] = r->color;
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      paint_scene
+*   Author(s):          George Cowan
+*   Definition:         paints all layers into expected screen back to front,
+                        ball lit pixels only
+*******************************************************************************/
+static void paint_scene(void) {
+    uint16_t row, col,
+             dim = (2 * ball.radius) + 1;
+
+    memset(expected, 0, sizeof(expected));
+    paint_rect(&border_left);
+    paint_rect(&border_right);
+    paint_rect(&paddle);
+
+    for (row = 0; row < dim; ++row) {
+        for (col = 0; col < dim; ++col) {
+            if (ball.b_map[row] & (1u << col)) {
+                expected[ball.center.y - ball.radius + row][ball.center.x - ball.radius + col] = ball.color;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      compare
+*   Author(s):          George Cowan
+*   Definition:         checks LCD stand-in screen against expected screen
+*   Parameters:         scene name, frame number
+*******************************************************************************/
+static void compare(const char *name, uint16_t frame) {
+    uint16_t x, y;
+
+    paint_scene();
+    for (y = 0; y < HEIGHT; ++y) {
+        for (x = 0; x < WIDTH; ++x) {
+            if (glcd_screen[y][x] != expected[y][x]) {
+                if (errors < 10) {
+                    printf("%s frame %u: pixel %u,%u is %04x, expected %04x\n",
+                           name, frame, x, y, glcd_screen[y][x], expected[y][x]);
+                }
+                ++errors;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      setup
+*   Author(s):          George Cowan
+*   Definition:         places borders, paddle and ball for scene
+*   Parameters:         scene
+*******************************************************************************/
+static void setup(const Scene *s) {
+    border_left = new_rect(new_point(0, 0), new_point(WIDTH - 1, BORDER_WIDTH - 1), DarkGrey);
+    border_right = new_rect(new_point(0, HEIGHT - BORDER_WIDTH), new_point(WIDTH - 1, HEIGHT - 1), DarkGrey);
+    paddle = new_rect(new_point(PADDLE_X0, PADDLE_Y0), new_point(PADDLE_X1, PADDLE_Y0 + PADDLE_WIDTH), Blue);
+    ball = new_ball(new_point(s->x, s->y), Yellow);
+    generate_bitmap(&ball);
+    ball_set.count = 1;
+    ball_set.color = ball.color;
+    ball_set.radius[0] = ball.radius;
+    ball_set.x[0] = ball.center.x;
+    ball_set.y[0] = ball.center.y;
+}
+
+/*******************************************************************************
+*   Function Name:      run_immediate
+*   Author(s):          George Cowan
+*   Definition:         runs scene drawing as before compositing, each moved
+                        object clears its old box and redraws itself, ball as
+                        13x13 box, paddle as fill plus uncovered strip
+*   Parameters:         scene, cost to fill
+*******************************************************************************/
+static void run_immediate(const Scene *s, Cost *c) {
+    Ball old;
+    Rect paddle_old,
+         strip;
+    uint16_t f,
+             dim;
+
+    setup(s);
+    dim = (2 * ball.radius) + 1;
+    GLCD_Init();
+    glcd_reset_stats();
+
+    for (f = 0; f < FRAMES; ++f) {
+        old = ball;
+        paddle_old = paddle;
+        shift_ball(&ball, s->vx, s->vy);
+        shift_rect_y(&paddle, s->paddle_vy);
+
+        if (!rect_is_pos_equal(&paddle_old, &paddle)) {
+            strip = subtract_rect_y(&paddle_old, &paddle, Black);
+            draw_rect(&paddle);
+            draw_rect(&strip);
+        }
+        if (!ball_is_pos_equal(&old, &ball)) {
+            sprite_blit_mask(old.center.x - old.radius, old.center.y - old.radius,
+                             dim, dim, old.b_map, Black, Black);
+            sprite_blit_mask(ball.center.x - ball.radius, ball.center.y - ball.radius,
+                             dim, dim, ball.b_map, ball.color, Black);
+        }
+    }
+
+    c->transactions = glcd_transactions;
+    c->pixels = glcd_pixels;
+}
+
+/*******************************************************************************
+*   Function Name:      run_composited
+*   Author(s):          George Cowan
+*   Definition:         runs scene through frame compositor as render task
+                        does, old and new areas of moved objects marked dirty
+                        and flushed once per frame, screen checked every frame
+*   Parameters:         scene, cost to fill
+*******************************************************************************/
+static void run_composited(const Scene *s, Cost *c) {
+    Rect paddle_old;
+    Ball old;
+    uint16_t f;
+
+    setup(s);
+    GLCD_Init();
+    frame_mark_dirty(0, 0, WIDTH - 1, HEIGHT - 1);
+    frame_flush();
+    compare(s->name, 0);
+    glcd_reset_stats();
+
+    for (f = 1; f <= FRAMES; ++f) {
+        old = ball;
+        paddle_old = paddle;
+        shift_ball(&ball, s->vx, s->vy);
+        shift_rect_y(&paddle, s->paddle_vy);
+
+        if (!rect_is_pos_equal(&paddle_old, &paddle)) {
+            frame_mark_rect(&paddle_old);
+            frame_mark_rect(&paddle);
+        }
+        if (!ball_is_pos_equal(&old, &ball)) {
+            ball_set.x[0] = ball.center.x;
+            ball_set.y[0] = ball.center.y;
+            frame_mark_circle(old.center.x, old.center.y, old.radius);
+            frame_mark_circle(ball.center.x, ball.center.y, ball.radius);
+        }
+        frame_flush();
+        compare(s->name, f);
+    }
+
+    c->transactions = glcd_transactions;
+    c->pixels = glcd_pixels;
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         runs each scene both ways and prints cost per frame
+*   Returns:            0 if every composited frame matched expected screen
+*******************************************************************************/
+int main(void) {
+    Cost before,
+         after;
+    uint8_t i;
+
+    frame_add_rect(&border_left);
+    frame_add_rect(&border_right);
+    frame_add_rect(&paddle);
+    frame_add_ball_set(&ball_set);
+
+    printf("%u frames per scene, per frame costs\n", FRAMES);
+    printf("%-14s %22s %22s\n", "", "before px / trans", "composited px / trans");
+    for (i = 0; i < sizeof(SCENES) / sizeof(SCENES[0]); ++i) {
+        run_immediate(&SCENES[i], &before);
+        run_composited(&SCENES[i], &after);
+        printf("%-14s %12.1f %9.1f %12.1f %9.1f\n", SCENES[i].name,
+               (double) before.pixels / FRAMES, (double) before.transactions / FRAMES,
+               (double) after.pixels / FRAMES, (double) after.transactions / FRAMES);
+    }
+    printf("pixel errors %u %s\n", errors, errors == 0 ? "ok" : "FAILED");
+
+    return errors == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
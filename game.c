@@ -0,0 +1,433 @@
+/*----------------------------------------------------------------------------
+* Filename:         game.c
+* Description:      Pong rules and state, no RTOS or LCD dependency, stepped
+*                   once per tick by tasks on Keil MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "prof.h"
+
+/*----------------------------------------------------------------------------
+ *      Game Constants
+ *---------------------------------------------------------------------------*/
+
+#define BALL_RADIUS_PX          6
+#define PADDLE_HEIGHT           10
+#define PADDLE_OFFSET           15
+#define CENTER_X                159
+#define CENTER_Y                (((BORDER_WIDTH - 1) + (240 - BORDER_WIDTH)) / 2)
+// balls are served from a grid centered on field, gap of 4 pixels
+#define SERVE_SPACING           ((2 * BALL_RADIUS_PX) + 4)
+#define SERVE_COLUMNS           8
+// brick mode walls, in cells, clear of serve grid and of paddles, gaps
+// to borders are too narrow for a ball
+#define WALL_LEFT_CELL          8
+#define WALL_RIGHT_CELL         28
+#define WALL_CELLS              4
+#define WALL_BOTTOM_CELL        2
+#define WALL_TOP_CELL           27
+
+static const int8_t DEFAULT_DIRECTION[2] = {4, 3};
+
+/*----------------------------------------------------------------------------
+ *      Bounce Table
+ *---------------------------------------------------------------------------*/
+
+#define BALL_SPEED_SLOW         7
+#define BALL_SPEED_FAST         15
+#define BOUNCE_MIN_ANGLE        15
+#define BOUNCE_MAX_ANGLE        80
+#define BOUNCE_HALF_WIDTH       (PADDLE_WIDTH / 2)
+#define BOUNCE_OFFSETS          32
+
+#if BOUNCE_HALF_WIDTH >= BOUNCE_OFFSETS
+#error "BOUNCE_OFFSETS must cover half of PADDLE_WIDTH"
+#endif
+
+/*
+bounce velocities are built by the compiler from the constants above and
+stored in flash, so changing the paddle width, angles or speeds rebuilds
+the table, nothing is computed at run time
+angle falls linearly from max at paddle center to min at paddle edge,
+sine is a Taylor series (error below 1e-8 up to 90 degrees) since library
+calls are not allowed in a constant initializer
+[speed index][hit offset from paddle center][x speed, y speed], x speed is
+rounded up and y speed down, signs are applied on collision
+*/
+#define BOUNCE_PI               3.14159265358979
+#define BOUNCE_RAD(o)           ((((BOUNCE_MIN_ANGLE - BOUNCE_MAX_ANGLE) / (BOUNCE_HALF_WIDTH * 1.0)) * (o) + \
+                                  BOUNCE_MAX_ANGLE) * BOUNCE_PI / 180.0)
+#define BOUNCE_SIN(a)           ((a) * (1.0 - ((a) * (a) / 6.0) * (1.0 - ((a) * (a) / 20.0) * (1.0 - ((a) * (a) / 42.0) * \
+                                  (1.0 - ((a) * (a) / 72.0) * (1.0 - ((a) * (a) / 110.0)))))))
+#define BOUNCE_COS(a)           BOUNCE_SIN((BOUNCE_PI / 2.0) - (a))
+#define BOUNCE_FLOOR(v)         ((int8_t) (v))
+#define BOUNCE_CEIL(v)          ((int8_t) ((int8_t) (v) + (((v) > (int8_t) (v)) ? 1 : 0)))
+#define BOUNCE(s, o)            { BOUNCE_CEIL((s) * BOUNCE_SIN(BOUNCE_RAD(o))), \
+                                  BOUNCE_FLOOR((s) * BOUNCE_COS(BOUNCE_RAD(o))) }
+#define BOUNCE_ROW(s)           { \
+                                  BOUNCE(s,  0), BOUNCE(s,  1), BOUNCE(s,  2), BOUNCE(s,  3), BOUNCE(s,  4), BOUNCE(s,  5), \
+                                  BOUNCE(s,  6), BOUNCE(s,  7), BOUNCE(s,  8), BOUNCE(s,  9), BOUNCE(s, 10), BOUNCE(s, 11), \
+                                  BOUNCE(s, 12), BOUNCE(s, 13), BOUNCE(s, 14), BOUNCE(s, 15), BOUNCE(s, 16), BOUNCE(s, 17), \
+                                  BOUNCE(s, 18), BOUNCE(s, 19), BOUNCE(s, 20), BOUNCE(s, 21), BOUNCE(s, 22), BOUNCE(s, 23), \
+                                  BOUNCE(s, 24), BOUNCE(s, 25), BOUNCE(s, 26), BOUNCE(s, 27), BOUNCE(s, 28), BOUNCE(s, 29), \
+                                  BOUNCE(s, 30), BOUNCE(s, 31) }
+
+static const int8_t BOUNCE_TABLE[2][BOUNCE_OFFSETS][2] = {
+    BOUNCE_ROW(BALL_SPEED_SLOW),
+    BOUNCE_ROW(BALL_SPEED_FAST)
+};
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      set_rect
+*   Author(s):          Alexander Rathke
+*   Definition:         sets rectangle corners, color is kept
+*   Parameters:         rectangle (modified), bottom left x and y, top right
+                        x and y
+*******************************************************************************/
+static void set_rect(Rect *r, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    r->b_left.x = x0;
+    r->b_left.y = y0;
+    r->t_right.x = x1;
+    r->t_right.y = y1;
+}
+
+/*******************************************************************************
+*   Function Name:      set_paddle_y
+*   Author(s):          Alexander Rathke
+*   Definition:         moves paddle along its line, clamped between borders
+*   Parameters:         paddle (modified), wanted bottom left y
+*******************************************************************************/
+static void set_paddle_y(Rect *paddle, uint16_t y) {
+    if (y < PADDLE_Y_MIN) {
+        y = PADDLE_Y_MIN;
+    }
+    else if (y > PADDLE_Y_MAX) {
+        y = PADDLE_Y_MAX;
+    }
+
+    paddle->b_left.y = y;
+    paddle->t_right.y = y + PADDLE_WIDTH;
+}
+
+/*******************************************************************************
+*   Function Name:      serve
+*   Author(s):          Alexander Rathke
+*   Definition:         resets ball to its serve position and default speed,
+                        a lone ball is served from center, in multi-ball
+                        mode every ball has its own place in serve grid and
+                        every other pair heads the other way across field
+*   Parameters:         game (modified), index of ball, x direction of serve
+                        (1 or -1)
+*******************************************************************************/
+static void serve(Game *g, uint8_t i, int8_t direction) {
+    BallSet *s = &g->balls;
+    uint16_t columns = (s->count < SERVE_COLUMNS) ? s->count : SERVE_COLUMNS,
+             rows = (s->count + SERVE_COLUMNS - 1) / SERVE_COLUMNS;
+
+    g->speed_index = 0;
+    g->ball_ticks = 0;
+    s->x[i] = CENTER_X + ((i % SERVE_COLUMNS) * SERVE_SPACING) - (((columns - 1) * SERVE_SPACING) / 2);
+    s->y[i] = CENTER_Y + ((i / SERVE_COLUMNS) * SERVE_SPACING) - (((rows - 1) * SERVE_SPACING) / 2);
+    s->vx[i] = direction * DEFAULT_DIRECTION[0];
+    s->vy[i] = ((i / 2) & 1) ? -DEFAULT_DIRECTION[1] : DEFAULT_DIRECTION[1];
+}
+
+/*******************************************************************************
+*   Function Name:      paddle_collision
+*   Author(s):          George Cowan
+*   Definition:         calculate ball bounce velocity with paddle, one lookup
+                        in bounce table
+*   Parameters:         game (ball modified), index of ball, paddle rectangle
+                        object
+*******************************************************************************/
+static void paddle_collision(Game *g, uint8_t i, Rect *paddle) {
+    int16_t half_width = BOUNCE_HALF_WIDTH;
+    const int8_t *bounce;
+    int8_t bounce_position = g->balls.y[i] - (((paddle->b_left.y) + (paddle->t_right.y)) / 2); //Relative position of ball, where 0 is center of paddle
+    uint32_t prof_start;
+
+    PROF_BEGIN(prof_start);
+
+    //If only a portion of ball is in contact with paddle, bounce with minimum angle.
+    if (bounce_position > half_width) {
+        bounce_position = half_width;
+    }
+    else if (bounce_position < -1 * half_width) {
+        bounce_position = -1 * half_width;
+    }
+
+    //velocity magnitudes after bounce
+    bounce = BOUNCE_TABLE[g->speed_index][abs(bounce_position)];
+
+    if (bounce_position <= 0) { //bounce towards left side of screen
+        g->balls.vy[i] = -1 * bounce[1];
+    }
+    else { //bounce towards right side of screen
+        g->balls.vy[i] = bounce[1];
+    }
+
+    if (g->balls.vx[i] >= 0) { //moving upwards
+        g->balls.vx[i] = -1 * bounce[0];
+    }
+    else { //moving downwards
+        g->balls.vx[i] = bounce[0];
+    }
+
+    PROF_END(PROF_PADDLE_COLLISION, prof_start);
+}
+
+/*******************************************************************************
+*   Function Name:      move_ball_swept
+*   Author(s):          George Cowan
+*   Definition:         calculates next ball position, ball is swept against
+                        paddles, borders and goal lines, so fast balls cannot
+                        pass through and several bounces may happen in one step
+                        move left over after a bounce continues with the new
+                        velocity, at most COLLIDE_MAX_BOUNCES contacts per step
+*   Parameters:         game (ball modified), index of ball
+                        bricks are swept separately by cell and win only if
+                        hit strictly first, a brick hit destroys it
+*   Returns:            events from move, goal events if ball reached a goal
+                        line
+*******************************************************************************/
+static uint16_t move_ball_swept(Game *g, uint8_t i) {
+    BallSet *s = &g->balls;
+    Contact contact,
+            brick;
+    Point center;
+    fixed_t remaining = FIXED_ONE;
+    int16_t dx,
+            dy;
+    int8_t velocity[2];
+    uint16_t cell;
+    uint8_t bounce;
+    uint16_t events = GAME_EVENT_BALL_MOVED;
+
+    for (bounce = 0; bounce < COLLIDE_MAX_BOUNCES; ++bounce) {
+        dx = fixed_trunc(s->vx[i] * remaining);
+        dy = fixed_trunc(s->vy[i] * remaining);
+        center.x = s->x[i];
+        center.y = s->y[i];
+
+        contact = collide_sweep(center, s->radius[i], dx, dy, g->colliders, COLLIDER_COUNT);
+        brick = bricks_sweep(&g->bricks, center, s->radius[i], dx, dy, &cell);
+        if (brick.index != COLLIDE_NONE && (contact.index == COLLIDE_NONE || brick.time < contact.time)) {
+            contact = brick;
+            // no collider has this index, handled with borders below
+            contact.index = COLLIDER_COUNT;
+            bricks_destroy(&g->bricks, cell);
+            events |= GAME_EVENT_BRICK_HIT;
+        }
+
+        if (contact.index == COLLIDE_NONE) { //No collision occurs -> only move
+            s->x[i] += dx;
+            s->y[i] += dy;
+            break;
+        }
+
+        //Update ball to location of collision
+        s->x[i] = contact.center.x;
+        s->y[i] = contact.center.y;
+        remaining = fixed_mul(remaining, FIXED_ONE - contact.time);
+
+        if (contact.index == COLLIDER_GOAL_BOTTOM) {
+            return events | GAME_EVENT_TOP_SCORE;
+        }
+        else if (contact.index == COLLIDER_GOAL_TOP) {
+            return events | GAME_EVENT_BOTTOM_SCORE;
+        }
+        else if (contact.index == COLLIDER_PADDLE_BOTTOM && contact.normal[0] != 0) {
+            //Update velocity vector, face or corner towards ball
+            paddle_collision(g, i, &g->paddle_bottom);
+            events |= GAME_EVENT_PADDLE_HIT;
+        }
+        else if (contact.index == COLLIDER_PADDLE_TOP && contact.normal[0] != 0) {
+            paddle_collision(g, i, &g->paddle_top);
+            events |= GAME_EVENT_PADDLE_HIT;
+        }
+        else { //Bounce off border, brick or side of paddle
+            velocity[0] = s->vx[i];
+            velocity[1] = s->vy[i];
+            collide_reflect(velocity, &contact);
+            s->vx[i] = velocity[0];
+            s->vy[i] = velocity[1];
+            if (contact.index <= COLLIDER_PADDLE_TOP) {
+                events |= GAME_EVENT_PADDLE_HIT;
+            }
+            else if (contact.index < COLLIDER_COUNT) {
+                events |= GAME_EVENT_BORDER_HIT;
+            }
+        }
+    }
+    return events;
+}
+
+/*******************************************************************************
+*   Function Name:      game_init
+*   Author(s):          Alexander Rathke
+*   Definition:         defines objects (balls, paddles, borders, goal lines),
+                        clears score and serves, object colors are left to
+                        caller
+*   Parameters:         game (modified), number of balls (1 for normal play,
+                        clamped to BALL_SET_MAX), true to play with bricks
+*******************************************************************************/
+void game_init(Game *g, uint8_t ball_count, bool brick_mode) {
+    uint16_t paddle_left_y = CENTER_Y - (PADDLE_WIDTH / 2);
+    uint8_t i;
+
+    set_rect(&g->paddle_bottom, PADDLE_OFFSET, paddle_left_y,
+             PADDLE_OFFSET + PADDLE_HEIGHT, paddle_left_y + PADDLE_WIDTH);
+    set_rect(&g->paddle_top, 319 - PADDLE_OFFSET - PADDLE_HEIGHT, paddle_left_y,
+             319 - PADDLE_OFFSET, paddle_left_y + PADDLE_WIDTH);
+    set_rect(&g->border_left, 0, 0, 319, BORDER_WIDTH - 1);
+    set_rect(&g->border_right, 0, 240 - BORDER_WIDTH, 319, 239);
+    set_rect(&g->goal_bottom, 0, 0, PADDLE_OFFSET + PADDLE_HEIGHT, 239);
+    set_rect(&g->goal_top, 319 - PADDLE_OFFSET - PADDLE_HEIGHT, 0, 319, 239);
+
+    g->colliders[COLLIDER_PADDLE_BOTTOM].rect = &g->paddle_bottom;
+    g->colliders[COLLIDER_PADDLE_TOP].rect = &g->paddle_top;
+    g->colliders[COLLIDER_BORDER_LEFT].rect = &g->border_left;
+    g->colliders[COLLIDER_BORDER_RIGHT].rect = &g->border_right;
+    g->colliders[COLLIDER_GOAL_BOTTOM].rect = &g->goal_bottom;
+    g->colliders[COLLIDER_GOAL_TOP].rect = &g->goal_top;
+    for (i = 0; i < COLLIDER_COUNT; ++i) {
+        g->colliders[i].sensor = (i >= COLLIDER_GOAL_BOTTOM);
+    }
+
+    if (ball_count < 1) {
+        ball_count = 1;
+    }
+    else if (ball_count > BALL_SET_MAX) {
+        ball_count = BALL_SET_MAX;
+    }
+    g->balls.count = ball_count;
+    g->brick_mode = brick_mode;
+    for (i = 0; i < BRICK_WORDS; ++i) {
+        g->bricks.cells[i] = 0;
+        g->bricks.changed[i] = 0;
+    }
+    g->bricks.count = 0;
+    for (i = 0; i < ball_count; ++i) {
+        g->balls.radius[i] = BALL_RADIUS_PX;
+        g->balls.order[i] = i;
+    }
+
+    game_new_match(g);
+}
+
+/*******************************************************************************
+*   Function Name:      game_new_match
+*   Author(s):          Alexander Rathke
+*   Definition:         clears score, lays bricks again in brick mode and
+                        serves every ball, paddles stay where they are
+*   Parameters:         game (modified)
+*******************************************************************************/
+void game_new_match(Game *g) {
+    uint8_t i;
+
+    g->top_score = 0;
+    g->bottom_score = 0;
+    g->over = false;
+
+    bricks_clear(&g->bricks);
+    if (g->brick_mode) {
+        bricks_fill(&g->bricks, WALL_LEFT_CELL, WALL_BOTTOM_CELL,
+                    WALL_LEFT_CELL + WALL_CELLS - 1, WALL_TOP_CELL);
+        bricks_fill(&g->bricks, WALL_RIGHT_CELL, WALL_BOTTOM_CELL,
+                    WALL_RIGHT_CELL + WALL_CELLS - 1, WALL_TOP_CELL);
+    }
+
+    for (i = 0; i < g->balls.count; ++i) {
+        serve(g, i, (i & 1) ? -1 : 1);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      game_step
+*   Author(s):          George Cowan, Alexander Rathke
+*   Definition:         advances game by one tick, paddles follow input every
+                        tick and balls move every GAME_BALL_PERIOD ticks
+                        balls are moved in index order in one pass, a ball
+                        that scores is served again at once, then touching
+                        balls bounce off each other
+                        same state and inputs always give same result, no
+                        effect once game is over
+*   Parameters:         game (modified), inputs sampled for this tick
+*   Returns:            GAME_EVENT bits of what happened
+*******************************************************************************/
+uint16_t game_step(Game *g, const GameInput *in) {
+    uint16_t events = 0,
+             moved;
+    uint8_t i;
+    uint32_t prof_start,
+             prof_move;
+
+    if (g->over) {
+        return 0;
+    }
+
+    g->speed_index = (g->speed_index + in->speed_toggles) % GAME_SPEEDS;
+    set_paddle_y(&g->paddle_top, in->paddle_top_y);
+    set_paddle_y(&g->paddle_bottom, in->paddle_bottom_y);
+
+    if (++g->ball_ticks < GAME_BALL_PERIOD) {
+        return 0;
+    }
+    g->ball_ticks = 0;
+
+    // only ticks that move balls are timed
+    PROF_BEGIN(prof_start);
+
+    for (i = 0; i < g->balls.count; ++i) {
+        PROF_BEGIN(prof_move);
+        moved = move_ball_swept(g, i);
+        PROF_END(PROF_BALL_MOVE, prof_move);
+        events |= moved;
+        if (!(moved & (GAME_EVENT_TOP_SCORE | GAME_EVENT_BOTTOM_SCORE))) {
+            continue;
+        }
+
+        if (moved & GAME_EVENT_TOP_SCORE) {
+            ++g->top_score;
+        }
+        else {
+            ++g->bottom_score;
+        }
+
+        if (g->top_score == GAME_MAX_SCORE || g->bottom_score == GAME_MAX_SCORE) {
+            // balls stay where they are until next match
+            g->over = true;
+            PROF_END(PROF_GAME_STEP, prof_start);
+            return events | GAME_EVENT_GAME_OVER;
+        }
+
+        // loser of point is served at
+        serve(g, i, (moved & GAME_EVENT_TOP_SCORE) ? 1 : -1);
+    }
+
+    if (collide_ball_set(&g->balls) > 0) {
+        events |= GAME_EVENT_BALL_HIT;
+    }
+
+    PROF_END(PROF_GAME_STEP, prof_start);
+    return events;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,80 @@
+/*----------------------------------------------------------------------------
+* Filename:         game.h
+* Description:      Pong rules and state, no RTOS or LCD dependency, stepped
+*                   once per tick by tasks on Keil MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _GAME_H
+#define _GAME_H
+
+// field geometry shared with input code
+#define BORDER_WIDTH            10
+#define PADDLE_WIDTH            52
+#define PADDLE_Y_MIN            BORDER_WIDTH
+#define PADDLE_Y_MAX            (239 - BORDER_WIDTH - PADDLE_WIDTH)
+
+// ticks between ball moves
+#define GAME_BALL_PERIOD        5
+#define GAME_SPEEDS             2
+#define GAME_MAX_SCORE          7
+
+// events returned by game_step, one bit each
+#define GAME_EVENT_TOP_SCORE    (1u << 0)
+#define GAME_EVENT_BOTTOM_SCORE (1u << 1)
+#define GAME_EVENT_GAME_OVER    (1u << 2)
+#define GAME_EVENT_PADDLE_HIT   (1u << 3)
+#define GAME_EVENT_BORDER_HIT   (1u << 4)
+#define GAME_EVENT_BALL_MOVED   (1u << 5)
+#define GAME_EVENT_BALL_HIT     (1u << 6)
+#define GAME_EVENT_BRICK_HIT    (1u << 7)
+
+// index of each rectangle ball is swept against, paddles come first so
+// they win ties with goal lines
+#define COLLIDER_PADDLE_BOTTOM  0
+#define COLLIDER_PADDLE_TOP     1
+#define COLLIDER_BORDER_LEFT    2
+#define COLLIDER_BORDER_RIGHT   3
+#define COLLIDER_GOAL_BOTTOM    4
+#define COLLIDER_GOAL_TOP       5
+#define COLLIDER_COUNT          6
+
+typedef struct {
+    /*
+    whole game, objects keep the types used for drawing
+    but only positions and velocity are touched here
+    */
+    // one ball normally, up to BALL_SET_MAX in multi-ball mode
+    BallSet balls;
+    Rect paddle_top, paddle_bottom;
+    Rect border_left, border_right;
+    // ball center crossing into goal line scores
+    Rect goal_bottom, goal_top;
+    Collider colliders[COLLIDER_COUNT];
+    // brick mode lays walls of bricks between paddles each match
+    Bricks bricks;
+    bool brick_mode;
+    uint8_t speed_index;
+    // ticks since balls last moved
+    uint8_t ball_ticks;
+    uint16_t top_score, bottom_score;
+    bool over;
+} Game;
+
+typedef struct {
+    // bottom left y wanted for each paddle, clamped to field
+    uint16_t paddle_top_y;
+    uint16_t paddle_bottom_y;
+    // push button presses since last step
+    uint8_t speed_toggles;
+} GameInput;
+
+void        game_init           (Game *g, uint8_t ball_count, bool brick_mode);
+void        game_new_match      (Game *g);
+uint16_t    game_step           (Game *g, const GameInput *in);
+
+#endif /* _GAME_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
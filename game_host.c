@@ -0,0 +1,230 @@
+/*----------------------------------------------------------------------------
+* Filename:         game_host.c
+* Description:      Linux benchmark of headless game core, steps game_step
+*                   with paddles following balls for one ball, brick mode
+*                   and multi-ball games, prints ticks and ball moves per
+*                   second, and runs each game twice to check same inputs
+*                   give same result, not part of board image, spans are
+*                   compiled out since host spans read clock every time
+*                   build: gcc -O2 -DPROF_ENABLED=0 -o game_host
+*                          game_host.c game.c collide.c bricks.c fixed.c
+*                          prof.c
+*                   run:   game_host [ticks per game] [seed]
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+
+/*----------------------------------------------------------------------------
+ *      Benchmark Constants
+ *---------------------------------------------------------------------------*/
+
+#define DEFAULT_TICKS           2000000
+// paddles follow ball with this much random error, so some balls are missed
+#define PADDLE_ERROR            40
+// ticks between changes of paddle error
+#define ERROR_PERIOD            64
+#define FNV_OFFSET              2166136261u
+#define FNV_PRIME               16777619u
+
+/*----------------------------------------------------------------------------
+ *      Benchmark Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    const char *name;
+    uint8_t ball_count;
+    bool brick_mode;
+} Setup;
+
+typedef struct {
+    uint32_t moves;
+    uint32_t matches;
+    uint32_t paddle_hits;
+    uint32_t brick_hits;
+    uint32_t ball_hits;
+    // FNV-1a of every tick's events and final balls
+    uint32_t sum;
+    uint64_t ns;
+} Result;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+static const Setup SETUPS[] = {
+    { "one ball",   1,  false },
+    { "bricks",     1,  true  },
+    { "8 balls",    8,  false },
+    { "32 balls",   BALL_SET_MAX, false }
+};
+
+static Game             game;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      now_ns
+*   Author(s):          George Cowan
+*   Definition:         reads monotonic clock
+*   Returns:            nanoseconds
+*******************************************************************************/
+static uint64_t now_ns(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t) t.tv_sec * 1000000000u) + t.tv_nsec;
+}
+
+/*******************************************************************************
+*   Function Name:      next_random
+*   Author(s):          George Cowan
+*   Definition:         xorshift generator, cheap next to game_step and same
+                        on every host
+*   Parameters:         state (modified, not zero)
+*   Returns:            next value
+*******************************************************************************/
+static uint32_t next_random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/*******************************************************************************
+*   Function Name:      follow
+*   Author(s):          George Cowan
+*   Definition:         paddle bottom left y centering paddle on a ball, off
+                        by error
+*   Parameters:         ball y, error
+*   Returns:            bottom left y, game clamps it to field
+*******************************************************************************/
+static uint16_t follow(uint16_t y, int16_t error) {
+    int16_t want = (int16_t) y - (PADDLE_WIDTH / 2) + error;
+
+    return (want < 0) ? 0 : (uint16_t) want;
+}
+
+/*******************************************************************************
+*   Function Name:      hash
+*   Author(s):          George Cowan
+*   Definition:         folds a 16-bit value into FNV-1a sum
+*   Parameters:         sum, value
+*   Returns:            new sum
+*******************************************************************************/
+static uint32_t hash(uint32_t sum, uint16_t value) {
+    sum = (sum ^ (value & 0xFF)) * FNV_PRIME;
+    return (sum ^ (value >> 8)) * FNV_PRIME;
+}
+
+/*******************************************************************************
+*   Function Name:      run
+*   Author(s):          George Cowan
+*   Definition:         plays game for a number of ticks, bottom paddle
+                        follows first ball and top paddle last ball, new
+                        match starts when one is over
+*   Parameters:         setup, ticks, random seed, result to fill
+*******************************************************************************/
+static void run(const Setup *s, uint32_t ticks, uint32_t seed, Result *r) {
+    GameInput in = { 0, 0, 0 };
+    uint32_t random = seed,
+             t;
+    uint16_t events;
+    int16_t error_top = 0,
+            error_bottom = 0;
+    uint8_t i,
+            last;
+
+    game_init(&game, s->ball_count, s->brick_mode);
+    last = game.balls.count - 1;
+    r->moves = r->matches = r->paddle_hits = r->brick_hits = r->ball_hits = 0;
+    r->sum = FNV_OFFSET;
+
+    r->ns = now_ns();
+    for (t = 0; t < ticks; ++t) {
+        if ((t % ERROR_PERIOD) == 0) {
+            error_top = (int16_t) (next_random(&random) % (2 * PADDLE_ERROR + 1)) - PADDLE_ERROR;
+            error_bottom = (int16_t) (next_random(&random) % (2 * PADDLE_ERROR + 1)) - PADDLE_ERROR;
+        }
+        in.paddle_bottom_y = follow(game.balls.y[0], error_bottom);
+        in.paddle_top_y = follow(game.balls.y[last], error_top);
+
+        events = game_step(&game, &in);
+        r->sum = hash(r->sum, events);
+        if (events == 0) {
+            continue;
+        }
+        r->moves += game.balls.count;
+        r->paddle_hits += (events & GAME_EVENT_PADDLE_HIT) != 0;
+        r->brick_hits += (events & GAME_EVENT_BRICK_HIT) != 0;
+        r->ball_hits += (events & GAME_EVENT_BALL_HIT) != 0;
+        if (events & GAME_EVENT_GAME_OVER) {
+            ++r->matches;
+            game_new_match(&game);
+        }
+    }
+    r->ns = now_ns() - r->ns;
+
+    for (i = 0; i < game.balls.count; ++i) {
+        r->sum = hash(r->sum, game.balls.x[i]);
+        r->sum = hash(r->sum, game.balls.y[i]);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         runs every setup twice and prints rates and counts
+*   Parameters:         ticks per game, random seed
+*   Returns:            0 if every repeated run matched
+*******************************************************************************/
+int main(int argc, char **argv) {
+    Result first,
+           second;
+    uint32_t ticks = (argc > 1) ? (uint32_t) atoi(argv[1]) : DEFAULT_TICKS,
+             seed = (argc > 2) ? (uint32_t) atoi(argv[2]) : 1,
+             errors = 0;
+    uint8_t i;
+
+    if (ticks == 0 || seed == 0) {
+        return 1;
+    }
+
+    printf("%u ticks per game, balls move every %u ticks\n", ticks, GAME_BALL_PERIOD);
+    printf("%-9s %12s %14s %10s %8s %10s %10s %10s %8s %6s\n", "", "ticks/s", "ball moves/s",
+           "ns/move", "matches", "paddle", "brick", "ball", "sum", "repeat");
+    for (i = 0; i < sizeof(SETUPS) / sizeof(SETUPS[0]); ++i) {
+        run(&SETUPS[i], ticks, seed, &first);
+        run(&SETUPS[i], ticks, seed, &second);
+        if (second.ns < first.ns) {
+            first.ns = second.ns;
+        }
+        errors += (first.sum != second.sum);
+        printf("%-9s %12.0f %14.0f %10.1f %8u %10u %10u %10u %08x %6s\n", SETUPS[i].name,
+               ticks / (first.ns / 1e9), first.moves / (first.ns / 1e9),
+               (double) first.ns / first.moves, first.matches, first.paddle_hits,
+               first.brick_hits, first.ball_hits, first.sum,
+               (first.sum == second.sum) ? "ok" : "FAILED");
+    }
+
+    return errors == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
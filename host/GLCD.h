@@ -0,0 +1,57 @@
+/*----------------------------------------------------------------------------
+* Filename:         GLCD.h
+* Description:      Linux stand-in for Keil MCB1700 GLCD library header, same
+*                   colors and calls as board copy plus bus counters, kept in
+*                   host/ so it never shadows board copy in project folder,
+*                   host tools build with -Ihost and link glcd_host.c
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _GLCD_H
+#define _GLCD_H
+
+#define WIDTH                   320
+#define HEIGHT                  240
+
+// RGB565 colors, same values as board library
+#define Black                   0x0000
+#define Navy                    0x000F
+#define DarkGreen               0x03E0
+#define DarkCyan                0x03EF
+#define Maroon                  0x7800
+#define Purple                  0x780F
+#define Olive                   0x7BE0
+#define LightGrey               0xC618
+#define DarkGrey                0x7BEF
+#define Blue                    0x001F
+#define Green                   0x07E0
+#define Cyan                    0x07FF
+#define Red                     0xF800
+#define Magenta                 0xF81F
+#define Yellow                  0xFFE0
+#define White                   0xFFFF
+
+// LCD bus usage since last glcd_reset_stats, one transaction per chip
+// select frame as board driver sends them
+extern uint32_t         glcd_transactions;
+extern uint32_t         glcd_bytes;
+extern uint32_t         glcd_pixels;
+// GRAM contents, row y column x
+extern unsigned short   glcd_screen[HEIGHT][WIDTH];
+
+void    GLCD_Init           (void);
+void    GLCD_WindowMax      (void);
+void    GLCD_PutPixel       (unsigned int x, unsigned int y);
+void    GLCD_SetTextColor   (unsigned short color);
+void    GLCD_SetBackColor   (unsigned short color);
+void    GLCD_Clear          (unsigned short color);
+void    GLCD_DisplayString  (unsigned int ln, unsigned int col, unsigned char fi, unsigned char *s);
+void    GLCD_Bitmap         (unsigned int x, unsigned int y, unsigned int w, unsigned int h,
+                             unsigned char *bitmap);
+void    glcd_reset_stats    (void);
+
+#endif /* _GLCD_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,118 @@
+/*----------------------------------------------------------------------------
+* Filename:         ece_spi_loopback.c
+* Description:      Linux stand-in for SSP0 and its GPDMA channels, MOSI wired
+*                   to MISO, supplies driver routines queue in
+*                   ece_spi_async.c runs transactions through, so host tools
+*                   check same queue board runs, not part of board image
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include "ece_spi.h"
+#include "ece_spi_loopback.h"
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+volatile int SPI_loopbackSelected = 0;
+SPI_device SPI_loopbackDevice = 0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      SPI_select
+*   Author(s):          George Cowan
+*   Definition:         no SSP0 here, chip select is only a flag
+*******************************************************************************/
+void SPI_select(void) {
+    SPI_loopbackSelected = 1;
+}
+
+/*******************************************************************************
+*   Function Name:      SPI_deselect
+*   Author(s):          George Cowan
+*   Definition:         clears chip select flag
+*******************************************************************************/
+void SPI_deselect(void) {
+    SPI_loopbackSelected = 0;
+}
+
+/*******************************************************************************
+*   Function Name:      SPI_asyncSetup
+*   Author(s):          George Cowan
+*   Definition:         no controller to power up or enable
+*******************************************************************************/
+void SPI_asyncSetup(void) {
+}
+
+/*******************************************************************************
+*   Function Name:      SPI_lock
+*   Author(s):          George Cowan
+*   Definition:         nothing to hold off, transfers only run from
+                        SPI_loopbackComplete
+*******************************************************************************/
+void SPI_lock(void) {
+}
+
+/*******************************************************************************
+*   Function Name:      SPI_unlock
+*   Author(s):          George Cowan
+*   Definition:         pairs with SPI_lock
+*******************************************************************************/
+void SPI_unlock(void) {
+}
+
+/*******************************************************************************
+*   Function Name:      SPI_start
+*   Author(s):          George Cowan
+*   Definition:         marks transaction running and selects device, no
+                        channels to program, SPI_loopbackComplete moves bytes
+*   Parameters:         transaction at front of queue
+*******************************************************************************/
+void SPI_start(SPI_transaction *t) {
+    t->status = SPI_ACTIVE;
+    SPI_select();
+}
+
+/*******************************************************************************
+*   Function Name:      SPI_loopbackComplete
+*   Author(s):          George Cowan
+*   Definition:         runs active transfer as GPDMA would and finishes it
+                        as DMA interrupt would, through attached device or
+                        tx echoed into rx
+*   Returns:            1 if one ran, 0 if queue is empty, -1 if chip select
+                        was not held for it
+*******************************************************************************/
+int SPI_loopbackComplete(void) {
+    SPI_transaction *t = SPI_active();
+    uint16_t i;
+    uint8_t byte;
+
+    if (t == 0) {
+        return 0;
+    }
+    if (!SPI_loopbackSelected) {
+        return -1;
+    }
+
+    if (SPI_loopbackDevice) {
+        SPI_loopbackDevice(t->command, t->tx, t->rx, t->length);
+    }
+    else {
+        for (i = 0; i < t->length; ++i) {
+            byte = t->tx ? t->tx[i] : 0;
+            if (t->rx) {
+                t->rx[i] = byte;
+            }
+        }
+    }
+    SPI_finish(SPI_DONE);
+    return 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,26 @@
+/*----------------------------------------------------------------------------
+* Filename:         ece_spi_loopback.h
+* Description:      Linux stand-in for SSP0 and its GPDMA channels, MOSI wired
+*                   to MISO, runs active SPI transaction as DMA would, not
+*                   part of board image
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _ECE_SPI_LOOPBACK_H
+#define _ECE_SPI_LOOPBACK_H
+
+// device answering in place of the wire, tx and rx may be NULL
+typedef void (*SPI_device)(uint8_t command, const uint8_t *tx, uint8_t *rx, uint16_t length);
+
+// chip select, set while a transaction runs
+extern volatile int SPI_loopbackSelected;
+// device attached, NULL echoes tx into rx
+extern SPI_device SPI_loopbackDevice;
+
+int     SPI_loopbackComplete    (void);
+
+#endif /* _ECE_SPI_LOOPBACK_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
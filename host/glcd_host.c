@@ -0,0 +1,216 @@
+/*----------------------------------------------------------------------------
+* Filename:         glcd_host.c
+* Description:      Linux stand-in for Keil MCB1700 GLCD library, keeps GRAM
+*                   in memory and counts LCD bus transactions the way
+*                   GLCD_SPI_LPC1700.c sends them, so host tools can measure
+*                   draw cost and check what was drawn, not part of board
+*                   image
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include "GLCD.h"
+
+/*----------------------------------------------------------------------------
+ *      Bus Constants
+ *---------------------------------------------------------------------------*/
+
+/*
+board driver sends every register index and every register value in its
+own chip select frame, start byte then 16 bits, a GRAM burst is one frame
+of start byte then 16 bits per pixel
+*/
+#define FRAME_BYTES             3
+// index and value frames for cursor registers 0x20 and 0x21
+#define CURSOR_FRAMES           4
+// window registers 0x50 to 0x53
+#define WINDOW_FRAMES           8
+// GRAM index 0x22, pixels follow in one more frame
+#define GRAM_FRAMES             1
+
+// display string fonts, fi 0 is 6x8, otherwise 16x24
+#define SMALL_CHAR_W            6
+#define SMALL_CHAR_H            8
+#define LARGE_CHAR_W            16
+#define LARGE_CHAR_H            24
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+uint32_t        glcd_transactions   = 0;
+uint32_t        glcd_bytes          = 0;
+uint32_t        glcd_pixels         = 0;
+unsigned short  glcd_screen[HEIGHT][WIDTH];
+
+static unsigned short text_color    = White;
+static unsigned short back_color    = Black;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      bus_frames
+*   Author(s):          George Cowan
+*   Definition:         counts register frames sent on LCD bus
+*   Parameters:         number of index or value frames
+*******************************************************************************/
+static void bus_frames(uint32_t frames) {
+    glcd_transactions += frames;
+    glcd_bytes += frames * FRAME_BYTES;
+}
+
+/*******************************************************************************
+*   Function Name:      bus_burst
+*   Author(s):          George Cowan
+*   Definition:         counts window setup, GRAM index and one burst of
+                        pixels sent on LCD bus
+*   Parameters:         pixels in burst
+*******************************************************************************/
+static void bus_burst(uint32_t pixels) {
+    bus_frames(WINDOW_FRAMES + CURSOR_FRAMES + GRAM_FRAMES);
+    ++glcd_transactions;
+    glcd_bytes += 1 + (2 * pixels);
+    glcd_pixels += pixels;
+}
+
+/*******************************************************************************
+*   Function Name:      fill_box
+*   Author(s):          George Cowan
+*   Definition:         sets GRAM inside box to one color, clipped to screen
+*   Parameters:         bottom left x and y, width, height, color
+*******************************************************************************/
+static void fill_box(unsigned int x, unsigned int y, unsigned int w, unsigned int h,
+                     unsigned short color) {
+    unsigned int i, j;
+
+    for (j = y; j < y + h && j < HEIGHT; ++j) {
+        for (i = x; i < x + w && i < WIDTH; ++i) {
+            glcd_screen[j][i] = color;
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      GLCD_Init
+*   Author(s):          George Cowan
+*   Definition:         clears GRAM to black, no bus cost counted
+*******************************************************************************/
+void GLCD_Init(void) {
+    memset(glcd_screen, 0, sizeof(glcd_screen));
+    text_color = White;
+    back_color = Black;
+}
+
+/*******************************************************************************
+*   Function Name:      GLCD_WindowMax
+*   Author(s):          George Cowan
+*   Definition:         restores full screen window
+*******************************************************************************/
+void GLCD_WindowMax(void) {
+    bus_frames(WINDOW_FRAMES);
+}
+
+/*******************************************************************************
+*   Function Name:      GLCD_PutPixel
+*   Author(s):          George Cowan
+*   Definition:         sets cursor and writes one pixel of text color
+*   Parameters:         x and y of pixel
+*******************************************************************************/
+void GLCD_PutPixel(unsigned int x, unsigned int y) {
+    bus_frames(CURSOR_FRAMES + GRAM_FRAMES + 1);
+    ++glcd_pixels;
+
+    if (x < WIDTH && y < HEIGHT) {
+        glcd_screen[y][x] = text_color;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      GLCD_SetTextColor
+*   Author(s):          George Cowan
+*   Definition:         sets color of later pixels and text, no bus cost
+*   Parameters:         color
+*******************************************************************************/
+void GLCD_SetTextColor(unsigned short color) {
+    text_color = color;
+}
+
+/*******************************************************************************
+*   Function Name:      GLCD_SetBackColor
+*   Author(s):          George Cowan
+*   Definition:         sets background color of later text, no bus cost
+*   Parameters:         color
+*******************************************************************************/
+void GLCD_SetBackColor(unsigned short color) {
+    back_color = color;
+}
+
+/*******************************************************************************
+*   Function Name:      GLCD_Clear
+*   Author(s):          George Cowan
+*   Definition:         fills whole screen in one burst
+*   Parameters:         color
+*******************************************************************************/
+void GLCD_Clear(unsigned short color) {
+    bus_burst((uint32_t) WIDTH * HEIGHT);
+    fill_box(0, 0, WIDTH, HEIGHT, color);
+}
+
+/*******************************************************************************
+*   Function Name:      GLCD_DisplayString
+*   Author(s):          George Cowan
+*   Definition:         counts one windowed burst per character, glyph cells
+                        are filled with background color, glyphs are not drawn
+*   Parameters:         line, column, font (0 small, otherwise large), string
+*******************************************************************************/
+void GLCD_DisplayString(unsigned int ln, unsigned int col, unsigned char fi, unsigned char *s) {
+    unsigned int w = (fi == 0) ? SMALL_CHAR_W : LARGE_CHAR_W,
+                 h = (fi == 0) ? SMALL_CHAR_H : LARGE_CHAR_H;
+
+    while (*s != '\0') {
+        bus_burst(w * h);
+        fill_box(col * w, ln * h, w, h, back_color);
+        ++col;
+        ++s;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      GLCD_Bitmap
+*   Author(s):          George Cowan
+*   Definition:         opens window over box and sends all pixels in one
+                        burst, row j of bitmap lands on line y + j
+*   Parameters:         bottom left x and y, width, height, w * h RGB565
+                        pixels
+*******************************************************************************/
+void GLCD_Bitmap(unsigned int x, unsigned int y, unsigned int w, unsigned int h,
+                 unsigned char *bitmap) {
+    unsigned short *pixels = (unsigned short *) bitmap;
+    unsigned int i, j;
+
+    bus_burst(w * h);
+
+    for (j = 0; j < h && y + j < HEIGHT; ++j) {
+        for (i = 0; i < w && x + i < WIDTH; ++i) {
+            glcd_screen[y + j][x + i] = pixels[(j * w) + i];
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      glcd_reset_stats
+*   Author(s):          George Cowan
+*   Definition:         clears bus counters, GRAM is kept
+*******************************************************************************/
+void glcd_reset_stats(void) {
+    glcd_transactions = 0;
+    glcd_bytes = 0;
+    glcd_pixels = 0;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,380 @@
+/*----------------------------------------------------------------------------
+* Filename:         imu.c
+* Description:      Tilt paddle input from MPU-9250 accelerometer on SSP0,
+*                   sensor FIFO is drained in one burst per poll by GPDMA
+*                   and filtered into a paddle position, uses only queued
+*                   SPI transfers so it builds on host against a stand-in
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "ece_spi.h"
+#include "imu.h"
+
+/*----------------------------------------------------------------------------
+ *      IMU Constants
+ *---------------------------------------------------------------------------*/
+
+// MPU-9250 registers
+#define MPU_SMPLRT_DIV          0x19
+#define MPU_CONFIG              0x1A
+#define MPU_ACCEL_CONFIG        0x1C
+#define MPU_ACCEL_CONFIG2       0x1D
+#define MPU_FIFO_EN             0x23
+#define MPU_USER_CTRL           0x6A
+#define MPU_PWR_MGMT_1          0x6B
+#define MPU_PWR_MGMT_2          0x6C
+#define MPU_FIFO_COUNTH         0x72
+#define MPU_FIFO_R_W            0x74
+#define MPU_WHO_AM_I            0x75
+#define MPU_ID                  0x71
+
+// USER_CTRL, SPI only, FIFO on, FIFO reset (clears itself)
+#define USER_CTRL_I2C_IF_DIS    0x10
+#define USER_CTRL_FIFO_EN       0x40
+#define USER_CTRL_FIFO_RST      0x04
+// FIFO_COUNTH holds top 5 bits of count
+#define FIFO_COUNT_HIGH_MASK    0x1F
+
+// tilt axis, 0 x, 1 y, 2 z, and its sign, tilting board by full range
+// either way moves paddle from border to border, +-0.5 g at +-2 g full
+// scale is about +-30 degrees
+#define IMU_AXIS                0
+#define IMU_TILT_SIGN           1
+#define IMU_TILT_RANGE          8192
+
+// one pole low pass on each sample, time constant is 2^shift samples,
+// 8 ms at 1 kHz
+#define IMU_LEVEL_SHIFT         4
+#define IMU_LEVEL_ONE           (1 << IMU_LEVEL_SHIFT)
+#define IMU_FILTER_SHIFT        3
+// paddle holds its pixel until filtered position is this far into next
+// one, in 1/256ths of a pixel, half a pixel stops sensor noise moving
+// paddle when tilt is held near a pixel edge
+#define IMU_HYSTERESIS          128
+#define IMU_Y_RANGE             (PADDLE_Y_MAX - PADDLE_Y_MIN)
+
+/*----------------------------------------------------------------------------
+ *      IMU Setup Table
+ *---------------------------------------------------------------------------*/
+
+/*
+written in order once sensor has answered WHO_AM_I,
+accelerometer only at 1 kHz with its 184 Hz low pass,
+FIFO keeps accelerometer samples and stops when full
+rather than overwriting, so what is read stays aligned
+*/
+static const uint8_t IMU_SETUP[][2] = {
+    { MPU_PWR_MGMT_1,       0x01 },
+    { MPU_USER_CTRL,        USER_CTRL_I2C_IF_DIS },
+    { MPU_PWR_MGMT_2,       0x07 },
+    { MPU_SMPLRT_DIV,       (1000 / IMU_SAMPLE_HZ) - 1 },
+    { MPU_CONFIG,           0x41 },
+    { MPU_ACCEL_CONFIG,     0x00 },
+    { MPU_ACCEL_CONFIG2,    0x01 },
+    { MPU_FIFO_EN,          0x08 },
+    { MPU_USER_CTRL,        USER_CTRL_I2C_IF_DIS | USER_CTRL_FIFO_RST },
+    { MPU_USER_CTRL,        USER_CTRL_I2C_IF_DIS | USER_CTRL_FIFO_EN }
+};
+
+#define IMU_SETUP_STEPS         (sizeof(IMU_SETUP) / sizeof(IMU_SETUP[0]))
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+volatile uint8_t imu_state = IMU_OFF;
+ImuStats imu_stats;
+
+// one transfer runs at a time, each step of a chain submits next from
+// previous one's callback
+static SPI_transaction  imu_xfer;
+static uint8_t          imu_value;
+static uint8_t          imu_count[2];
+static uint8_t          imu_step;
+static uint8_t          imu_fifo[IMU_BURST_SAMPLES * IMU_SAMPLE_BYTES];
+// bytes of last burst not yet taken by imu_read
+static volatile uint32_t imu_length = 0;
+static volatile bool    imu_draining = false;
+static SPI_callback     imu_ready;
+static void             *imu_ready_context;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      imu_notify
+*   Author(s):          George Cowan
+*   Definition:         ends a setup or drain chain and tells caller
+*******************************************************************************/
+static void imu_notify(void) {
+    imu_draining = false;
+    if (imu_ready != 0) {
+        imu_ready(imu_ready_context);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      imu_fail
+*   Author(s):          George Cowan
+*   Definition:         gives up on sensor during setup
+*******************************************************************************/
+static void imu_fail(void) {
+    ++imu_stats.errors;
+    imu_state = IMU_FAILED;
+    imu_notify();
+}
+
+/*******************************************************************************
+*   Function Name:      imu_configured
+*   Author(s):          George Cowan
+*   Definition:         SPI callback, writes next setup register, sensor is
+                        running once last one is written
+*   Parameters:         unused
+*******************************************************************************/
+static void imu_configured(void *context) {
+    (void) context;
+
+    if (imu_xfer.status != SPI_DONE) {
+        imu_fail();
+        return;
+    }
+
+    if (imu_step == IMU_SETUP_STEPS) {
+        imu_state = IMU_RUNNING;
+        imu_notify();
+        return;
+    }
+
+    imu_value = IMU_SETUP[imu_step][1];
+    if (!SPI_writeAsync(&imu_xfer, IMU_SETUP[imu_step][0], &imu_value, 1, imu_configured, 0)) {
+        imu_fail();
+        return;
+    }
+    ++imu_step;
+}
+
+/*******************************************************************************
+*   Function Name:      imu_identified
+*   Author(s):          George Cowan
+*   Definition:         SPI callback, checks WHO_AM_I and starts setup writes
+*   Parameters:         unused
+*******************************************************************************/
+static void imu_identified(void *context) {
+    if (imu_xfer.status != SPI_DONE || imu_count[0] != MPU_ID) {
+        imu_fail();
+        return;
+    }
+
+    imu_step = 0;
+    imu_configured(context);
+}
+
+/*******************************************************************************
+*   Function Name:      imu_start
+*   Author(s):          George Cowan
+*   Definition:         starts sensor setup and returns at once, ready is
+                        called from DMA interrupt when imu_state leaves
+                        IMU_CONFIGURING, and again at end of every drain
+                        SPI_setup and SPI_asyncSetup must have run
+*   Parameters:         ready callback, its context
+*******************************************************************************/
+void imu_start(SPI_callback ready, void *context) {
+    imu_ready = ready;
+    imu_ready_context = context;
+    imu_length = 0;
+    imu_draining = false;
+
+    imu_stats.polls = 0;
+    imu_stats.busy = 0;
+    imu_stats.samples = 0;
+    imu_stats.overflows = 0;
+    imu_stats.errors = 0;
+
+    imu_state = IMU_CONFIGURING;
+    if (!SPI_readAsync(&imu_xfer, MPU_WHO_AM_I, imu_count, 1, imu_identified, 0)) {
+        imu_fail();
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      imu_drained
+*   Author(s):          George Cowan
+*   Definition:         SPI callback, burst or FIFO reset finished
+*   Parameters:         unused
+*******************************************************************************/
+static void imu_drained(void *context) {
+    (void) context;
+
+    if (imu_xfer.status != SPI_DONE) {
+        ++imu_stats.errors;
+    }
+    else if (imu_xfer.rx == imu_fifo) {
+        imu_length = imu_xfer.length;
+        imu_stats.samples += imu_xfer.length / IMU_SAMPLE_BYTES;
+    }
+    imu_notify();
+}
+
+/*******************************************************************************
+*   Function Name:      imu_counted
+*   Author(s):          George Cowan
+*   Definition:         SPI callback, reads whole samples waiting in FIFO in
+                        one burst, a FIFO that may have filled is reset
+                        instead since a cut off sample would misalign the
+                        rest
+*   Parameters:         unused
+*******************************************************************************/
+static void imu_counted(void *context) {
+    uint32_t count;
+
+    (void) context;
+
+    if (imu_xfer.status != SPI_DONE) {
+        ++imu_stats.errors;
+        imu_notify();
+        return;
+    }
+
+    count = ((uint32_t) (imu_count[0] & FIFO_COUNT_HIGH_MASK) << 8) | imu_count[1];
+
+    if (count > IMU_FIFO_BYTES - IMU_SAMPLE_BYTES) {
+        ++imu_stats.overflows;
+        imu_value = USER_CTRL_I2C_IF_DIS | USER_CTRL_FIFO_EN | USER_CTRL_FIFO_RST;
+        if (!SPI_writeAsync(&imu_xfer, MPU_USER_CTRL, &imu_value, 1, imu_drained, 0)) {
+            imu_notify();
+        }
+        return;
+    }
+
+    count /= IMU_SAMPLE_BYTES;
+    if (count > IMU_BURST_SAMPLES) {
+        count = IMU_BURST_SAMPLES;
+    }
+    if (count == 0 ||
+        !SPI_readAsync(&imu_xfer, MPU_FIFO_R_W, imu_fifo, count * IMU_SAMPLE_BYTES, imu_drained, 0)) {
+        imu_notify();
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      imu_poll
+*   Author(s):          George Cowan
+*   Definition:         starts draining sensor FIFO and returns at once, two
+                        transfers per poll however many samples wait, FIFO
+                        count then one burst, ready callback is called when
+                        done, call at a fixed rate so FIFO never fills
+*   Returns:            true if drain was started
+*******************************************************************************/
+bool imu_poll(void) {
+    if (imu_state != IMU_RUNNING) {
+        return false;
+    }
+    if (imu_draining) {
+        ++imu_stats.busy;
+        return false;
+    }
+
+    ++imu_stats.polls;
+    imu_draining = true;
+    imu_length = 0;
+    if (!SPI_readAsync(&imu_xfer, MPU_FIFO_COUNTH, imu_count, 2, imu_counted, 0)) {
+        imu_draining = false;
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+*   Function Name:      imu_read
+*   Author(s):          George Cowan
+*   Definition:         takes samples of last finished drain, valid until
+                        next imu_poll
+*   Parameters:         set to first byte of samples
+*   Returns:            bytes of samples, 0 if none new
+*******************************************************************************/
+uint32_t imu_read(const uint8_t **bytes) {
+    uint32_t length = imu_length;
+
+    imu_length = 0;
+    *bytes = imu_fifo;
+
+    return length;
+}
+
+/*******************************************************************************
+*   Function Name:      imu_filter_init
+*   Author(s):          George Cowan
+*   Definition:         starts filter with paddle where it is, first sample
+                        sets level so paddle does not sweep in from middle
+*   Parameters:         filter (modified), paddle position
+*******************************************************************************/
+void imu_filter_init(ImuFilter *f, uint16_t paddle_y) {
+    f->level = 0;
+    f->paddle_y = paddle_y;
+    f->primed = false;
+}
+
+/*******************************************************************************
+*   Function Name:      imu_filter
+*   Author(s):          George Cowan
+*   Definition:         low pass filters every sample along tilt axis, then
+                        maps level linearly to paddle position, paddle only
+                        moves once level is IMU_HYSTERESIS past middle of
+                        its pixel so noise does not make it jitter
+*   Parameters:         filter (modified), FIFO bytes, number of bytes
+*   Returns:            paddle position
+*******************************************************************************/
+uint16_t imu_filter(ImuFilter *f, const uint8_t *fifo, uint32_t length) {
+    const uint8_t *p;
+    int32_t a,
+            level,
+            y,
+            held;
+
+    for (p = fifo; p + IMU_SAMPLE_BYTES <= fifo + length; p += IMU_SAMPLE_BYTES) {
+        a = IMU_TILT_SIGN * (int16_t) ((p[2 * IMU_AXIS] << 8) | p[(2 * IMU_AXIS) + 1]);
+        if (!f->primed) {
+            f->level = a * IMU_LEVEL_ONE;
+            f->primed = true;
+        }
+        else {
+            f->level += ((a * IMU_LEVEL_ONE) - f->level) >> IMU_FILTER_SHIFT;
+        }
+    }
+    if (!f->primed) {
+        return f->paddle_y;
+    }
+
+    level = f->level / IMU_LEVEL_ONE;
+    if (level < -IMU_TILT_RANGE) {
+        level = -IMU_TILT_RANGE;
+    }
+    else if (level > IMU_TILT_RANGE) {
+        level = IMU_TILT_RANGE;
+    }
+
+    // position in 1/256ths of a pixel above PADDLE_Y_MIN
+    y = ((level + IMU_TILT_RANGE) * IMU_Y_RANGE * 256) / (2 * IMU_TILT_RANGE);
+    held = (f->paddle_y - PADDLE_Y_MIN) * 256;
+    if (y > held + 128 + IMU_HYSTERESIS || y < held - 128 - IMU_HYSTERESIS) {
+        f->paddle_y = PADDLE_Y_MIN + ((y + 128) >> 8);
+    }
+
+    return f->paddle_y;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,58 @@
+/*----------------------------------------------------------------------------
+* Filename:         imu.h
+* Description:      Tilt paddle input from MPU-9250 accelerometer on SSP0,
+*                   sensor FIFO is drained in one burst per poll by GPDMA
+*                   and filtered into a paddle position, uses only queued
+*                   SPI transfers so it builds on host against a stand-in
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _IMU_H
+#define _IMU_H
+
+// accelerometer output rate, samples collect in sensor FIFO between polls
+#define IMU_SAMPLE_HZ           1000
+// x, y, z, 16-bit big endian each
+#define IMU_SAMPLE_BYTES        6
+#define IMU_FIFO_BYTES          512
+// most samples taken per poll, more wait for next poll
+#define IMU_BURST_SAMPLES       32
+
+// imu_state
+#define IMU_OFF                 0
+#define IMU_CONFIGURING         1
+#define IMU_RUNNING             2
+// sensor did not answer WHO_AM_I, or a transfer failed during setup
+#define IMU_FAILED              3
+
+typedef struct {
+    // accel along tilt axis, IMU_LEVEL_SHIFT fraction bits
+    int32_t level;
+    uint16_t paddle_y;
+    bool primed;
+} ImuFilter;
+
+typedef struct {
+    uint32_t polls;
+    // polls refused because last drain had not finished
+    uint32_t busy;
+    uint32_t samples;
+    // FIFO filled between polls and was reset, samples lost
+    uint32_t overflows;
+    uint32_t errors;
+} ImuStats;
+
+extern volatile uint8_t imu_state;
+extern ImuStats imu_stats;
+
+void        imu_start       (SPI_callback ready, void *context);
+bool        imu_poll        (void);
+uint32_t    imu_read        (const uint8_t **bytes);
+void        imu_filter_init (ImuFilter *f, uint16_t paddle_y);
+uint16_t    imu_filter      (ImuFilter *f, const uint8_t *fifo, uint32_t length);
+
+#endif /* _IMU_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
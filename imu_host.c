@@ -0,0 +1,436 @@
+/*----------------------------------------------------------------------------
+* Filename:         imu_host.c
+* Description:      Linux check of tilt paddle against a scripted MPU-9250
+*                   stand-in on the SPI loopback, sensor fills its FIFO at
+*                   1 kHz from a tilt script with noise, imu is polled once
+*                   per 10 ms game tick and paddle is compared with where
+*                   noiseless tilt puts it, not part of board image
+*                   build: gcc -I. -Ihost -o imu_host imu_host.c imu.c
+*                          ece_spi_async.c host/ece_spi_loopback.c -lm
+*                   run:   imu_host [seed]
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "ece_spi.h"
+#include "ece_spi_loopback.h"
+#include "imu.h"
+
+/*----------------------------------------------------------------------------
+ *      Check Constants
+ *---------------------------------------------------------------------------*/
+
+#define TICK_MS                 10
+#define RUN_MS                  7000
+// raw accelerometer noise either way, about 7 mg, more than the sensor
+// shows behind its 184 Hz low pass
+#define NOISE                   120
+// raw tilt mapped to full paddle range, as in imu.c
+#define TILT_RANGE              8192
+// polls skipped here so FIFO fills and must be reset
+#define STALL_FROM_MS           6300
+#define STALL_TO_MS             6500
+// ticks paddle may take to get within TRACK_PIXELS of a new tilt
+#define SETTLE_MS               50
+#define TRACK_PIXELS            1
+#define LATENCY_MAX_MS          30
+
+// stand-in registers
+#define REG_USER_CTRL           0x6A
+#define REG_FIFO_EN             0x23
+#define REG_CONFIG              0x1A
+#define REG_FIFO_COUNTH         0x72
+#define REG_FIFO_COUNTL         0x73
+#define REG_FIFO_R_W            0x74
+#define REG_WHO_AM_I            0x75
+
+/*----------------------------------------------------------------------------
+ *      Check Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    uint8_t regs[128];
+    uint8_t fifo[IMU_FIFO_BYTES];
+    uint32_t fifo_length;
+    uint32_t transfers;
+    uint32_t partial_samples;
+    uint8_t who_am_i;
+} Sensor;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+static Sensor   sensor;
+static bool     ready = false;
+static uint32_t errors = 0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      fail
+*   Author(s):          George Cowan
+*   Definition:         reports a failed check, first few only
+*   Parameters:         message, time it concerns
+*******************************************************************************/
+static void fail(const char *message, int32_t ms) {
+    if (errors < 10) {
+        printf("%5d ms: %s\n", ms, message);
+    }
+    ++errors;
+}
+
+/*******************************************************************************
+*   Function Name:      sensor_read
+*   Author(s):          George Cowan
+*   Definition:         reads one register of stand-in, FIFO_R_W pops FIFO
+*   Parameters:         register
+*   Returns:            value
+*******************************************************************************/
+static uint8_t sensor_read(uint8_t reg) {
+    uint8_t value;
+
+    if (reg == REG_WHO_AM_I) {
+        return sensor.who_am_i;
+    }
+    if (reg == REG_FIFO_COUNTH) {
+        return (uint8_t) (sensor.fifo_length >> 8);
+    }
+    if (reg == REG_FIFO_COUNTL) {
+        return (uint8_t) sensor.fifo_length;
+    }
+    if (reg == REG_FIFO_R_W) {
+        if (sensor.fifo_length == 0) {
+            return 0xFF;
+        }
+        value = sensor.fifo[0];
+        memmove(sensor.fifo, sensor.fifo + 1, --sensor.fifo_length);
+        return value;
+    }
+
+    return sensor.regs[reg];
+}
+
+/*******************************************************************************
+*   Function Name:      sensor_transfer
+*   Author(s):          George Cowan
+*   Definition:         answers one SPI transaction as MPU-9250 would,
+                        register address steps after each byte except on
+                        FIFO_R_W, writing FIFO_RST empties FIFO
+*   Parameters:         command byte, bytes sent, bytes received (either
+                        may be NULL), number of bytes
+*******************************************************************************/
+static void sensor_transfer(uint8_t command, const uint8_t *tx, uint8_t *rx, uint16_t length) {
+    uint8_t reg = command & 0x7F,
+            value;
+    uint16_t i;
+
+    ++sensor.transfers;
+    for (i = 0; i < length; ++i) {
+        if (command & 0x80) {
+            value = sensor_read(reg);
+            if (rx != NULL) {
+                rx[i] = value;
+            }
+        }
+        else {
+            sensor.regs[reg] = (tx != NULL) ? tx[i] : 0;
+            if (reg == REG_USER_CTRL && (sensor.regs[reg] & 0x04)) {
+                sensor.fifo_length = 0;
+                sensor.regs[reg] &= ~0x04;
+            }
+        }
+        if (reg != REG_FIFO_R_W) {
+            reg = (reg + 1) & 0x7F;
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      sensor_sample
+*   Author(s):          George Cowan
+*   Definition:         one accelerometer sample into FIFO if it is on,
+                        FIFO that stops when full takes only the bytes that
+                        fit, which is what leaves a cut off sample
+*   Parameters:         x, y, z raw
+*******************************************************************************/
+static void sensor_sample(int16_t x, int16_t y, int16_t z) {
+    uint8_t bytes[IMU_SAMPLE_BYTES];
+    uint8_t i;
+
+    if (!(sensor.regs[REG_USER_CTRL] & 0x40) || !(sensor.regs[REG_FIFO_EN] & 0x08)) {
+        return;
+    }
+
+    bytes[0] = (uint8_t) ((uint16_t) x >> 8);
+    bytes[1] = (uint8_t) x;
+    bytes[2] = (uint8_t) ((uint16_t) y >> 8);
+    bytes[3] = (uint8_t) y;
+    bytes[4] = (uint8_t) ((uint16_t) z >> 8);
+    bytes[5] = (uint8_t) z;
+
+    if (sensor.fifo_length + IMU_SAMPLE_BYTES > IMU_FIFO_BYTES) {
+        if (!(sensor.regs[REG_CONFIG] & 0x40)) {
+            fail("FIFO left in overwrite mode", -1);
+        }
+        if (sensor.fifo_length < IMU_FIFO_BYTES) {
+            ++sensor.partial_samples;
+        }
+    }
+    for (i = 0; i < IMU_SAMPLE_BYTES && sensor.fifo_length < IMU_FIFO_BYTES; ++i) {
+        sensor.fifo[sensor.fifo_length++] = bytes[i];
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      tilt
+*   Author(s):          George Cowan
+*   Definition:         scripted raw tilt, holds, steps, a sine and a tilt
+                        past full range
+*   Parameters:         time
+*   Returns:            raw accelerometer along tilt axis
+*******************************************************************************/
+static int32_t tilt(int32_t ms) {
+    if (ms < 1000) {
+        return 0;
+    }
+    if (ms < 2000) {
+        return 5000;
+    }
+    if (ms < 3000) {
+        return -7000;
+    }
+    if (ms < 5000) {
+        return (int32_t) (6000.0 * sin(2.0 * M_PI * (ms - 3000) / 1000.0));
+    }
+    if (ms < 6000) {
+        return 12000;
+    }
+    return -2000;
+}
+
+/*******************************************************************************
+*   Function Name:      is_hold
+*   Author(s):          George Cowan
+*   Definition:         tells if tilt has been still long enough that paddle
+                        must have settled
+*   Parameters:         time
+*   Returns:            true during settled part of a hold
+*******************************************************************************/
+static bool is_hold(int32_t ms) {
+    int32_t start = (ms / 1000) * 1000;
+
+    if (ms >= 3000 && ms < 5000) {
+        return false;
+    }
+    if (ms >= STALL_FROM_MS && ms < STALL_TO_MS + SETTLE_MS) {
+        return false;
+    }
+    return ms - start >= SETTLE_MS;
+}
+
+/*******************************************************************************
+*   Function Name:      ideal_y
+*   Author(s):          George Cowan
+*   Definition:         paddle position noiseless tilt maps to
+*   Parameters:         raw tilt
+*   Returns:            paddle position
+*******************************************************************************/
+static int32_t ideal_y(int32_t a) {
+    if (a < -TILT_RANGE) {
+        a = -TILT_RANGE;
+    }
+    else if (a > TILT_RANGE) {
+        a = TILT_RANGE;
+    }
+    return PADDLE_Y_MIN + ((a + TILT_RANGE) * (PADDLE_Y_MAX - PADDLE_Y_MIN) + TILT_RANGE) / (2 * TILT_RANGE);
+}
+
+/*******************************************************************************
+*   Function Name:      on_ready
+*   Author(s):          George Cowan
+*   Definition:         imu ready callback, where board sets a task event
+*   Parameters:         unused
+*******************************************************************************/
+static void on_ready(void *context) {
+    (void) context;
+
+    ready = true;
+}
+
+/*******************************************************************************
+*   Function Name:      pump
+*   Author(s):          George Cowan
+*   Definition:         runs queued transfers until imu says it is ready
+*   Returns:            transfers run
+*******************************************************************************/
+static uint32_t pump(void) {
+    uint32_t n = 0;
+
+    while (!ready && SPI_loopbackComplete() > 0) {
+        ++n;
+    }
+    ready = false;
+
+    return n;
+}
+
+/*******************************************************************************
+*   Function Name:      check_setup
+*   Author(s):          George Cowan
+*   Definition:         checks a sensor with wrong WHO_AM_I is refused, then
+                        sets up stand-in and checks registers imu relies on
+*******************************************************************************/
+static void check_setup(void) {
+    memset(&sensor, 0, sizeof(sensor));
+    sensor.who_am_i = 0x68;
+    imu_start(on_ready, NULL);
+    pump();
+    if (imu_state != IMU_FAILED || imu_poll()) {
+        fail("wrong sensor accepted", 0);
+    }
+
+    memset(&sensor, 0, sizeof(sensor));
+    sensor.who_am_i = 0x71;
+    imu_start(on_ready, NULL);
+    pump();
+    if (imu_state != IMU_RUNNING) {
+        fail("setup did not finish", 0);
+    }
+    if (sensor.regs[REG_USER_CTRL] != 0x50 || sensor.regs[REG_FIFO_EN] != 0x08 ||
+        !(sensor.regs[REG_CONFIG] & 0x40)) {
+        fail("FIFO not set up", 0);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         sets up stand-in, runs tilt script polling once per
+                        tick, checks paddle settles fast and holds still,
+                        that each poll costs two transfers and that a
+                        filled FIFO is recovered from
+*   Parameters:         random seed
+*   Returns:            0 if every check passed
+*******************************************************************************/
+int main(int argc, char **argv) {
+    ImuFilter filter;
+    const uint8_t *fifo;
+    uint32_t length,
+             transfers,
+             polls = 0,
+             poll_transfers = 0,
+             moves_in_hold = 0;
+    int32_t ms,
+            tick,
+            a,
+            y = (PADDLE_Y_MIN + PADDLE_Y_MAX) / 2,
+            y_old,
+            target,
+            target_old = -1,
+            changed_ms = 0,
+            latency_max = 0,
+            hold_error_max = 0,
+            track_error_max = 0;
+    bool settled = true;
+
+    srand((argc > 1) ? (unsigned) atoi(argv[1]) : 1);
+    SPI_loopbackDevice = sensor_transfer;
+    SPI_asyncSetup();
+
+    check_setup();
+    imu_filter_init(&filter, (uint16_t) y);
+
+    for (ms = 0; ms < RUN_MS; ms += TICK_MS) {
+        for (tick = 0; tick < TICK_MS; ++tick) {
+            a = tilt(ms + tick) + (rand() % (2 * NOISE + 1)) - NOISE;
+            sensor_sample((int16_t) a, (int16_t) (rand() % 64), 16384);
+        }
+
+        y_old = y;
+        if (ms < STALL_FROM_MS || ms >= STALL_TO_MS) {
+            transfers = sensor.transfers;
+            if (imu_poll()) {
+                pump();
+                ++polls;
+                poll_transfers += sensor.transfers - transfers;
+            }
+            length = imu_read(&fifo);
+            if (length % IMU_SAMPLE_BYTES != 0) {
+                fail("burst not whole samples", ms);
+            }
+            y = imu_filter(&filter, fifo, length);
+        }
+
+        // paddle reflects samples up to end of this tick
+        target = ideal_y(tilt(ms + TICK_MS - 1));
+        if (target != target_old && (ms < 3000 || ms >= 5000)) {
+            changed_ms = ms;
+            settled = false;
+        }
+        target_old = target;
+
+        if (!settled && abs(y - target) <= TRACK_PIXELS) {
+            settled = true;
+            if (ms - changed_ms > latency_max && ms >= 1000) {
+                latency_max = ms - changed_ms;
+            }
+        }
+        if (is_hold(ms)) {
+            if (abs(y - target) > hold_error_max) {
+                hold_error_max = abs(y - target);
+            }
+            if (y != y_old) {
+                ++moves_in_hold;
+            }
+        }
+        else if (ms >= 3100 && ms < 5000 && abs(y - target) > track_error_max) {
+            track_error_max = abs(y - target);
+        }
+    }
+
+    if (latency_max > LATENCY_MAX_MS) {
+        fail("paddle slow to follow tilt", latency_max);
+    }
+    if (hold_error_max > TRACK_PIXELS) {
+        fail("paddle off while tilt held", hold_error_max);
+    }
+    if (moves_in_hold > 10) {
+        fail("paddle jitters while tilt held", moves_in_hold);
+    }
+    if (poll_transfers != 2 * polls) {
+        fail("poll took other than two transfers", poll_transfers);
+    }
+    if (imu_stats.overflows == 0 || sensor.partial_samples == 0) {
+        fail("stall did not fill FIFO", STALL_FROM_MS);
+    }
+    if (imu_stats.busy != 0 || imu_stats.errors != 0) {
+        fail("drain busy or failed", 0);
+    }
+
+    printf("polls %u samples %u overflows %u transfers/poll %.2f | latency %d ms hold error %d px"
+           " moves in hold %u sine error %d px | %s\n",
+           polls, imu_stats.samples, imu_stats.overflows, polls ? (double) poll_transfers / polls : 0.0,
+           latency_max, hold_error_max, moves_in_hold, track_error_max, errors == 0 ? "ok" : "FAILED");
+
+    return errors == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,179 @@
+/*----------------------------------------------------------------------------
+* Filename:         input.c
+* Description:      Maps raw potentiometer, joystick and push button samples
+*                   to pong game input on Keil MCB1700 board, no hardware
+*                   access so recorded samples can be replayed
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "input.h"
+#include "prof.h"
+
+/*----------------------------------------------------------------------------
+ *      Input Constants
+ *---------------------------------------------------------------------------*/
+
+// joystick pixels per sample
+#define JOYSTICK_STEP           11
+
+/*----------------------------------------------------------------------------
+ *      Potentiometer Table
+ *---------------------------------------------------------------------------*/
+
+#define POT_READINGS            4096
+// readings below min map to highest position and above max to lowest
+#define POT_MIN                 100
+#define POT_MAX                 4000
+#define POT_HYSTERESIS          10
+#define POT_RANGE               (POT_MAX - POT_MIN)
+#define POT_Y_RANGE             (PADDLE_Y_MAX - PADDLE_Y_MIN)
+// readings per paddle pixel and reading at which step 0 ends, both
+// rounded down as the float mapping did
+#define POT_STEP                (POT_RANGE / POT_Y_RANGE)
+#define POT_EDGE                (POT_MAX + ((PADDLE_Y_MIN * POT_RANGE) / POT_Y_RANGE))
+
+#if POT_Y_RANGE > 255 || PADDLE_Y_MAX > 255
+#error "paddle positions must fit POT_TABLE entries and POT_HOLD rows"
+#endif
+
+/*
+position for every 12-bit reading and hold band of every position are
+built by the compiler from the constants above and stored in flash,
+nothing is computed at run time
+position falls linearly from PADDLE_Y_MAX at POT_MIN to PADDLE_Y_MIN at
+POT_MAX, rounded up
+paddle at y stays put while reading is strictly inside POT_HOLD[y], band
+is the readings of step y widened by POT_HYSTERESIS on each side, paddle
+against highest border only leaves once reading passes POT_MIN plus
+hysteresis, and the step next to it has no hysteresis toward border
+*/
+#define POT_CLAMP(v)            (((v) < POT_MIN) ? POT_MIN : (((v) > POT_MAX) ? POT_MAX : (v)))
+#define POT_Y(v)                (PADDLE_Y_MIN + (((POT_Y_RANGE * (POT_MAX - POT_CLAMP(v))) + POT_RANGE - 1) / POT_RANGE))
+#define POT_Y4(v)               POT_Y(v), POT_Y((v) + 1), POT_Y((v) + 2), POT_Y((v) + 3)
+#define POT_Y16(v)              POT_Y4(v), POT_Y4((v) + 4), POT_Y4((v) + 8), POT_Y4((v) + 12)
+#define POT_Y64(v)              POT_Y16(v), POT_Y16((v) + 16), POT_Y16((v) + 32), POT_Y16((v) + 48)
+#define POT_Y256(v)             POT_Y64(v), POT_Y64((v) + 64), POT_Y64((v) + 128), POT_Y64((v) + 192)
+#define POT_Y1024(v)            POT_Y256(v), POT_Y256((v) + 256), POT_Y256((v) + 512), POT_Y256((v) + 768)
+
+// first reading of steps y + 1 and y - 1 bound band, band never spans
+// a reading more than one step away
+#define POT_FIRST(y)            (POT_MAX - ((POT_RANGE * ((y) - PADDLE_Y_MIN)) / POT_Y_RANGE))
+#define POT_BIGGER(a, b)        (((a) > (b)) ? (a) : (b))
+#define POT_SMALLER(a, b)       (((a) < (b)) ? (a) : (b))
+#define POT_HOLD_LO(y)          POT_BIGGER(POT_EDGE - POT_STEP - POT_HYSTERESIS - \
+                                           (((POT_RANGE * (y)) + POT_Y_RANGE - 1) / POT_Y_RANGE), \
+                                           POT_FIRST((y) + 1) - 1)
+#define POT_HOLD_HI(y)          POT_SMALLER(POT_EDGE + POT_HYSTERESIS - ((POT_RANGE * (y)) / POT_Y_RANGE), \
+                                            ((y) < PADDLE_Y_MIN + 2) ? POT_READINGS : POT_FIRST((y) - 2))
+#define POT_BAND(y)             { ((y) == PADDLE_Y_MAX) ? -1 : \
+                                  ((((y) == PADDLE_Y_MAX - 1) && POT_HOLD_LO(y) < POT_MIN) ? POT_MIN : POT_HOLD_LO(y)), \
+                                  ((y) == PADDLE_Y_MAX) ? (POT_MIN + POT_HYSTERESIS) : POT_HOLD_HI(y) }
+#define POT_BAND4(y)            POT_BAND(y), POT_BAND((y) + 1), POT_BAND((y) + 2), POT_BAND((y) + 3)
+#define POT_BAND16(y)           POT_BAND4(y), POT_BAND4((y) + 4), POT_BAND4((y) + 8), POT_BAND4((y) + 12)
+#define POT_BAND64(y)           POT_BAND16(y), POT_BAND16((y) + 16), POT_BAND16((y) + 32), POT_BAND16((y) + 48)
+
+static const uint8_t POT_TABLE[POT_READINGS] = {
+    POT_Y1024(0), POT_Y1024(1024), POT_Y1024(2048), POT_Y1024(3072)
+};
+
+// [position][lowest, highest reading], both exclusive, only rows
+// PADDLE_Y_MIN to PADDLE_Y_MAX are used
+static const int16_t POT_HOLD[256][2] = {
+    POT_BAND64(0), POT_BAND64(64), POT_BAND64(128), POT_BAND64(192)
+};
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      input_pot
+*   Author(s):          George Cowan
+*   Definition:         maps potentiometer reading to top paddle position,
+                        paddle only moves one pixel once reading leaves a
+                        hysteresis band around old step, so noise does not
+                        make it jitter
+                        one table load for position and two compares
+                        against hold band of old position
+*   Parameters:         game input (top paddle modified), 12-bit reading
+*******************************************************************************/
+void input_pot(GameInput *in, uint16_t pot_val) {
+    uint16_t y_old = in->paddle_top_y;
+    uint32_t prof_start;
+
+    PROF_BEGIN(prof_start);
+
+    pot_val &= POT_READINGS - 1;
+
+    if (y_old <= PADDLE_Y_MAX && pot_val > POT_HOLD[y_old][0] && pot_val < POT_HOLD[y_old][1]) {
+        in->paddle_top_y = y_old;
+    }
+    else {
+        in->paddle_top_y = POT_TABLE[pot_val];
+    }
+
+    PROF_END(PROF_INPUT_POT, prof_start);
+}
+
+/*******************************************************************************
+*   Function Name:      input_joystick
+*   Author(s):          Alexander Rathke
+*   Definition:         steps bottom paddle by joystick direction, shifts to
+                        border if close to it
+*   Parameters:         game input (bottom paddle modified), joystick reading
+*******************************************************************************/
+void input_joystick(GameInput *in, uint32_t pos) {
+    if (pos == 32 || pos == 33) {
+        // move right
+        in->paddle_bottom_y = (in->paddle_bottom_y + JOYSTICK_STEP < PADDLE_Y_MAX) ?
+                              (in->paddle_bottom_y + JOYSTICK_STEP) : PADDLE_Y_MAX;
+    }
+    else if (pos == 8 || pos == 9) {
+        // move left
+        in->paddle_bottom_y = (in->paddle_bottom_y > PADDLE_Y_MIN + JOYSTICK_STEP) ?
+                              (in->paddle_bottom_y - JOYSTICK_STEP) : PADDLE_Y_MIN;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      input_button
+*   Author(s):          George Cowan
+*   Definition:         counts push button press, ball speed cycles on next
+                        game step
+*   Parameters:         game input (modified)
+*******************************************************************************/
+void input_button(GameInput *in) {
+    ++in->speed_toggles;
+}
+
+/*******************************************************************************
+*   Function Name:      input_tilt
+*   Author(s):          George Cowan
+*   Definition:         sets top paddle to position filtered from tilt
+                        sensor, filter runs before recording so replay
+                        needs only the position
+*   Parameters:         game input (top paddle modified), paddle position
+*******************************************************************************/
+void input_tilt(GameInput *in, uint16_t paddle_y) {
+    if (paddle_y < PADDLE_Y_MIN) {
+        paddle_y = PADDLE_Y_MIN;
+    }
+    else if (paddle_y > PADDLE_Y_MAX) {
+        paddle_y = PADDLE_Y_MAX;
+    }
+    in->paddle_top_y = paddle_y;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
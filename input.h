@@ -0,0 +1,21 @@
+/*----------------------------------------------------------------------------
+* Filename:         input.h
+* Description:      Maps raw potentiometer, joystick and push button samples
+*                   to pong game input on Keil MCB1700 board, no hardware
+*                   access so recorded samples can be replayed
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _INPUT_H
+#define _INPUT_H
+
+void    input_pot       (GameInput *in, uint16_t pot_val);
+void    input_joystick  (GameInput *in, uint32_t pos);
+void    input_button    (GameInput *in);
+void    input_tilt      (GameInput *in, uint16_t paddle_y);
+
+#endif /* _INPUT_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
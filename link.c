@@ -0,0 +1,463 @@
+/*----------------------------------------------------------------------------
+* Filename:         link.c
+* Description:      Two board pong over a serial link, each board sends only
+*                   its own paddle input, remote input is predicted and game
+*                   is rolled back and stepped again when prediction was
+*                   wrong, no RTOS or UART dependency so it builds on host
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "link.h"
+
+/*----------------------------------------------------------------------------
+ *      Link Constants
+ *---------------------------------------------------------------------------*/
+
+#define LINK_SLOT(f)            ((uint32_t) (f) & (LINK_HISTORY - 1))
+
+// FNV-1a, state checksum only has to differ when states differ
+#define FNV_OFFSET              2166136261u
+#define FNV_PRIME               16777619u
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      link_hash
+*   Author(s):          George Cowan
+*   Definition:         adds one value to checksum, low byte first
+*   Parameters:         checksum so far, value
+*   Returns:            new checksum
+*******************************************************************************/
+static uint32_t link_hash(uint32_t h, uint32_t v) {
+    uint8_t i;
+
+    for (i = 0; i < 4; ++i) {
+        h = (h ^ (v & 0xFF)) * FNV_PRIME;
+        v >>= 8;
+    }
+
+    return h;
+}
+
+/*******************************************************************************
+*   Function Name:      link_checksum
+*   Author(s):          George Cowan
+*   Definition:         checksum of everything game_step reads or writes, so
+                        boards that step same inputs agree and boards that
+                        drifted apart do not
+*   Parameters:         game
+*   Returns:            16-bit checksum
+*******************************************************************************/
+uint16_t link_checksum(const Game *g) {
+    uint32_t h = FNV_OFFSET;
+    uint8_t i;
+
+    for (i = 0; i < g->balls.count; ++i) {
+        h = link_hash(h, ((uint32_t) g->balls.x[i] << 16) | g->balls.y[i]);
+        h = link_hash(h, ((uint32_t) (uint8_t) g->balls.vx[i] << 8) | (uint8_t) g->balls.vy[i]);
+    }
+    for (i = 0; i < BRICK_WORDS; ++i) {
+        h = link_hash(h, g->bricks.cells[i]);
+    }
+    h = link_hash(h, ((uint32_t) g->paddle_top.b_left.y << 16) | g->paddle_bottom.b_left.y);
+    h = link_hash(h, ((uint32_t) g->top_score << 16) | g->bottom_score);
+    h = link_hash(h, ((uint32_t) g->speed_index << 16) | ((uint32_t) g->ball_ticks << 8) | g->over);
+
+    return (uint16_t) (h ^ (h >> 16));
+}
+
+/*******************************************************************************
+*   Function Name:      link_fletcher
+*   Author(s):          George Cowan
+*   Definition:         fletcher-16 over packet bytes
+*   Parameters:         bytes, number of bytes
+*   Returns:            second sum in high byte, first sum in low byte
+*******************************************************************************/
+static uint16_t link_fletcher(const uint8_t *bytes, uint32_t length) {
+    uint16_t sum1 = 0,
+             sum2 = 0;
+    uint32_t i;
+
+    for (i = 0; i < length; ++i) {
+        sum1 = (sum1 + bytes[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+
+    return (sum2 << 8) | sum1;
+}
+
+/*******************************************************************************
+*   Function Name:      link_expand
+*   Author(s):          George Cowan
+*   Definition:         widens 16-bit frame from packet to frame nearest
+                        this board's frame, boards are never more than a
+                        few frames apart
+*   Parameters:         link, low 16 bits of frame
+*   Returns:            frame
+*******************************************************************************/
+static int32_t link_expand(const Link *k, uint16_t wire) {
+    return k->frame + (int16_t) (wire - (uint16_t) k->frame);
+}
+
+/*******************************************************************************
+*   Function Name:      link_init
+*   Author(s):          George Cowan
+*   Definition:         starts link at frame 0 with no inputs from other
+                        board, game must be in same state on both boards
+*   Parameters:         link (modified), paddle this board controls
+*******************************************************************************/
+void link_init(Link *k, uint8_t side) {
+    uint8_t i;
+
+    for (i = 0; i < LINK_HISTORY; ++i) {
+        k->remote_frame[i] = -1;
+        k->sums[i] = 0;
+    }
+    k->predicted_frame = -1;
+    k->frame = 0;
+    k->confirmed = 0;
+    k->received = 0;
+    k->remote_ack = 0;
+    k->rollback = 0;
+    k->check_pending = false;
+    k->over_reported = false;
+    k->side = side;
+    k->rx_len = 0;
+
+    k->stats.frames = 0;
+    k->stats.stalls = 0;
+    k->stats.rollbacks = 0;
+    k->stats.resimulated = 0;
+    k->stats.rollback_max = 0;
+    k->stats.desyncs = 0;
+    k->stats.packets = 0;
+    k->stats.bad_packets = 0;
+}
+
+/*******************************************************************************
+*   Function Name:      link_simulate
+*   Author(s):          George Cowan
+*   Definition:         saves game and steps one frame with local input and
+                        remote input if known, latest remote paddle with no
+                        presses otherwise, either board's new match request
+                        restarts a finished game before frame is stepped
+*   Parameters:         link (modified), game (modified), frame to step
+*   Returns:            GAME_EVENT bits from step
+*******************************************************************************/
+static uint16_t link_simulate(Link *k, Game *g, int32_t f) {
+    uint32_t slot = LINK_SLOT(f);
+    const LinkInput *local = &k->local[slot],
+                    *remote,
+                    *top,
+                    *bottom;
+    GameInput in;
+
+    if (k->remote_frame[slot] == f) {
+        k->used[slot] = k->remote[slot];
+    }
+    else {
+        k->used[slot].paddle_y = (k->predicted_frame >= 0) ? k->predicted.paddle_y :
+                                 (k->side == LINK_SIDE_TOP) ? g->paddle_bottom.b_left.y :
+                                                              g->paddle_top.b_left.y;
+        k->used[slot].speed_toggles = 0;
+    }
+    remote = &k->used[slot];
+
+    // same order on both boards, whichever board is local
+    top = (k->side == LINK_SIDE_TOP) ? local : remote;
+    bottom = (k->side == LINK_SIDE_TOP) ? remote : local;
+    in.paddle_top_y = top->paddle_y;
+    in.paddle_bottom_y = bottom->paddle_y;
+    in.speed_toggles = (top->speed_toggles & LINK_TOGGLES_MASK) +
+                       (bottom->speed_toggles & LINK_TOGGLES_MASK);
+
+    k->states[slot] = *g;
+
+    if (g->over && ((top->speed_toggles | bottom->speed_toggles) & LINK_NEW_MATCH)) {
+        game_new_match(g);
+    }
+
+    return game_step(g, &in);
+}
+
+/*******************************************************************************
+*   Function Name:      link_restore
+*   Author(s):          George Cowan
+*   Definition:         puts game back to a saved state, bricks that differ
+                        are marked changed so they are drawn again
+*   Parameters:         game (modified), saved state
+*******************************************************************************/
+static void link_restore(Game *g, const Game *saved) {
+    uint32_t changed[BRICK_WORDS];
+    uint8_t i;
+
+    for (i = 0; i < BRICK_WORDS; ++i) {
+        changed[i] = g->bricks.changed[i] | saved->bricks.changed[i] |
+                     (g->bricks.cells[i] ^ saved->bricks.cells[i]);
+    }
+
+    *g = *saved;
+
+    for (i = 0; i < BRICK_WORDS; ++i) {
+        g->bricks.changed[i] = changed[i];
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      link_confirm
+*   Author(s):          George Cowan
+*   Definition:         makes frames final once remote input is known, keeps
+                        checksum of each final state and compares it with
+                        other board's, game over is only reported once it is
+                        final
+*   Parameters:         link (modified), game, events (game over added)
+*******************************************************************************/
+static void link_confirm(Link *k, const Game *g, uint16_t *events) {
+    const Game *after;
+
+    while (k->confirmed < k->frame && k->remote_frame[LINK_SLOT(k->confirmed)] == k->confirmed) {
+        after = (k->confirmed + 1 < k->frame) ? &k->states[LINK_SLOT(k->confirmed + 1)] : g;
+        k->sums[LINK_SLOT(k->confirmed)] = link_checksum(after);
+
+        if (after->over && !k->over_reported) {
+            *events |= GAME_EVENT_GAME_OVER;
+        }
+        k->over_reported = after->over;
+
+        ++k->confirmed;
+    }
+
+    if (k->check_pending && k->check_frame < k->confirmed) {
+        if (k->check_frame >= k->confirmed - LINK_HISTORY &&
+            k->sums[LINK_SLOT(k->check_frame)] != k->check_sum) {
+            ++k->stats.desyncs;
+        }
+        k->check_pending = false;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      link_step
+*   Author(s):          George Cowan
+*   Definition:         rolls back to first wrongly predicted frame and steps
+                        again up to present, then steps one new frame with
+                        local input, unless board is LINK_HISTORY frames
+                        ahead of other board, then it waits
+                        score events of rolled back frames may repeat, game
+                        over is only reported once final
+*   Parameters:         link (modified), game (modified), local input for
+                        new frame, events (set to GAME_EVENT bits)
+*   Returns:            true if a new frame was stepped
+*******************************************************************************/
+bool link_step(Link *k, Game *g, const LinkInput *local, uint16_t *events) {
+    int32_t f;
+    uint32_t replayed;
+
+    *events = 0;
+
+    if (k->rollback < k->frame) {
+        link_restore(g, &k->states[LINK_SLOT(k->rollback)]);
+        for (f = k->rollback; f < k->frame; ++f) {
+            *events |= link_simulate(k, g, f) & ~GAME_EVENT_GAME_OVER;
+        }
+        // positive since rollback is behind frame
+        replayed = (uint32_t) (k->frame - k->rollback);
+        ++k->stats.rollbacks;
+        k->stats.resimulated += replayed;
+        if (replayed > k->stats.rollback_max) {
+            k->stats.rollback_max = replayed;
+        }
+    }
+    k->rollback = k->frame;
+    link_confirm(k, g, events);
+
+    // oldest saved state and oldest unacknowledged input must survive
+    if (k->frame - k->confirmed >= LINK_HISTORY || k->frame - k->remote_ack >= LINK_HISTORY) {
+        ++k->stats.stalls;
+        return false;
+    }
+
+    k->local[LINK_SLOT(k->frame)] = *local;
+    *events |= link_simulate(k, g, k->frame) & ~GAME_EVENT_GAME_OVER;
+    ++k->frame;
+    k->rollback = k->frame;
+    ++k->stats.frames;
+
+    link_confirm(k, g, events);
+    return true;
+}
+
+/*******************************************************************************
+*   Function Name:      link_encode
+*   Author(s):          George Cowan
+*   Definition:         builds packet of every local input other board has
+                        not acknowledged, with acknowledgement and checksum
+                        of last final state, sent once per tick so lost
+                        packets are made up by next one
+*   Parameters:         link, packet (LINK_PACKET_MAX bytes, modified)
+*   Returns:            packet length
+*******************************************************************************/
+uint8_t link_encode(Link *k, uint8_t *out) {
+    int32_t first = k->remote_ack,
+            check = k->confirmed - 1;
+    uint16_t sum = (check >= 0) ? k->sums[LINK_SLOT(check)] : 0;
+    uint8_t count,
+            n,
+            i;
+    const LinkInput *in;
+
+    if (k->frame - first > LINK_HISTORY) {
+        first = k->frame - LINK_HISTORY;
+    }
+    count = (uint8_t) (k->frame - first);
+
+    out[0] = LINK_SYNC0;
+    out[1] = LINK_SYNC1;
+    out[2] = (uint8_t) first;
+    out[3] = (uint8_t) (first >> 8);
+    out[4] = count;
+    out[5] = (uint8_t) k->received;
+    out[6] = (uint8_t) (k->received >> 8);
+    out[7] = (uint8_t) check;
+    out[8] = (uint8_t) (check >> 8);
+    out[9] = (uint8_t) sum;
+    out[10] = (uint8_t) (sum >> 8);
+
+    n = LINK_HEADER;
+    for (i = 0; i < count; ++i) {
+        in = &k->local[LINK_SLOT(first + i)];
+        out[n++] = (uint8_t) in->paddle_y;
+        out[n++] = (uint8_t) (in->paddle_y >> 8);
+        out[n++] = in->speed_toggles;
+    }
+
+    sum = link_fletcher(out, n);
+    out[n++] = (uint8_t) sum;
+    out[n++] = (uint8_t) (sum >> 8);
+
+    return n;
+}
+
+/*******************************************************************************
+*   Function Name:      link_apply
+*   Author(s):          George Cowan
+*   Definition:         takes remote inputs from a checked packet, an input
+                        that differs from prediction already stepped marks
+                        frame for rollback
+*   Parameters:         link (modified), whole packet
+*******************************************************************************/
+static void link_apply(Link *k, const uint8_t *p) {
+    int32_t first = link_expand(k, p[2] | (p[3] << 8)),
+            ack = link_expand(k, p[5] | (p[6] << 8)),
+            check = link_expand(k, p[7] | (p[8] << 8)),
+            r;
+    uint32_t slot;
+    uint8_t count = p[4],
+            i;
+    LinkInput in;
+
+    for (i = 0; i < count; ++i) {
+        r = first + i;
+        if (r < k->confirmed || r >= k->confirmed + LINK_HISTORY) {
+            continue;
+        }
+        slot = LINK_SLOT(r);
+        if (k->remote_frame[slot] == r) {
+            continue;
+        }
+
+        in.paddle_y = p[LINK_HEADER + (i * LINK_INPUT_BYTES)] |
+                      (p[LINK_HEADER + (i * LINK_INPUT_BYTES) + 1] << 8);
+        in.speed_toggles = p[LINK_HEADER + (i * LINK_INPUT_BYTES) + 2];
+        k->remote[slot] = in;
+        k->remote_frame[slot] = r;
+
+        if (r < k->rollback && (in.paddle_y != k->used[slot].paddle_y ||
+                                in.speed_toggles != k->used[slot].speed_toggles)) {
+            k->rollback = r;
+        }
+        if (r > k->predicted_frame) {
+            k->predicted = in;
+            k->predicted_frame = r;
+        }
+    }
+
+    while (k->received < k->confirmed + LINK_HISTORY &&
+           k->remote_frame[LINK_SLOT(k->received)] == k->received) {
+        ++k->received;
+    }
+
+    if (ack > k->remote_ack) {
+        k->remote_ack = ack;
+    }
+
+    if (check >= 0 && (!k->check_pending || check > k->check_frame)) {
+        k->check_frame = check;
+        k->check_sum = p[9] | (p[10] << 8);
+        k->check_pending = true;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      link_receive
+*   Author(s):          George Cowan
+*   Definition:         feeds received bytes through packet framing, bytes
+                        may arrive in any split, damaged packets are
+                        dropped and counted and framing looks for next sync
+*   Parameters:         link (modified), bytes, number of bytes
+*******************************************************************************/
+void link_receive(Link *k, const uint8_t *bytes, uint32_t length) {
+    uint32_t i;
+    uint8_t b,
+            n;
+
+    for (i = 0; i < length; ++i) {
+        b = bytes[i];
+
+        if (k->rx_len == 0 && b != LINK_SYNC0) {
+            continue;
+        }
+        if (k->rx_len == 1 && b != LINK_SYNC1) {
+            k->rx_len = (b == LINK_SYNC0) ? 1 : 0;
+            continue;
+        }
+        k->rx[k->rx_len++] = b;
+
+        if (k->rx_len == 5 && k->rx[4] > LINK_HISTORY) {
+            ++k->stats.bad_packets;
+            k->rx_len = 0;
+            continue;
+        }
+        if (k->rx_len < LINK_HEADER) {
+            continue;
+        }
+
+        n = LINK_HEADER + (k->rx[4] * LINK_INPUT_BYTES);
+        if (k->rx_len == n + 2) {
+            if (link_fletcher(k->rx, n) == (k->rx[n] | (k->rx[n + 1] << 8))) {
+                ++k->stats.packets;
+                link_apply(k, k->rx);
+            }
+            else {
+                ++k->stats.bad_packets;
+            }
+            k->rx_len = 0;
+        }
+    }
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,113 @@
+/*----------------------------------------------------------------------------
+* Filename:         link.h
+* Description:      Two board pong over a serial link, each board sends only
+*                   its own paddle input, remote input is predicted and game
+*                   is rolled back and stepped again when prediction was
+*                   wrong, no RTOS or UART dependency so it builds on host
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _LINK_H
+#define _LINK_H
+
+// frames kept for rollback, must be a power of two, also most frames a
+// board runs ahead of inputs it has from other board
+#define LINK_HISTORY            8
+
+// paddle each board controls
+#define LINK_SIDE_BOTTOM        0
+#define LINK_SIDE_TOP           1
+
+// speed_toggles bit asking for next match once game is over, the rest
+// count push button presses
+#define LINK_NEW_MATCH          0x80
+#define LINK_TOGGLES_MASK       0x7F
+
+// packet on the wire, little endian
+//   0   LINK_SYNC0, LINK_SYNC1
+//   2   frame of first input (low 16 bits)
+//   4   input count, at most LINK_HISTORY
+//   5   ack, sender has every input below this frame (low 16 bits)
+//   7   check frame, last frame sender has final state of (low 16 bits)
+//   9   checksum of sender state after check frame
+//   11  inputs, 3 bytes each, paddle y then speed_toggles
+//   end fletcher-16 of every byte before it
+#define LINK_SYNC0              0xA5
+#define LINK_SYNC1              0x5A
+#define LINK_HEADER             11
+#define LINK_INPUT_BYTES        3
+#define LINK_PACKET_MAX         (LINK_HEADER + (LINK_HISTORY * LINK_INPUT_BYTES) + 2)
+
+typedef struct {
+    // bottom left y wanted for paddle of one board
+    uint16_t paddle_y;
+    // push button presses, LINK_NEW_MATCH if set
+    uint8_t speed_toggles;
+} LinkInput;
+
+typedef struct {
+    uint32_t frames;
+    // ticks that could not step, waiting on other board
+    uint32_t stalls;
+    uint32_t rollbacks;
+    uint32_t resimulated;
+    uint32_t rollback_max;
+    // final states that did not match other board
+    uint32_t desyncs;
+    uint32_t packets;
+    uint32_t bad_packets;
+} LinkStats;
+
+typedef struct {
+    /*
+    frame f uses slot f % LINK_HISTORY of every ring,
+    states hold game before frame was stepped, frames
+    below confirmed used real inputs of both boards
+    and can never be rolled back
+    */
+    Game states[LINK_HISTORY];
+    LinkInput local[LINK_HISTORY];
+    LinkInput remote[LINK_HISTORY];
+    // remote input each frame was stepped with, real or predicted
+    LinkInput used[LINK_HISTORY];
+    // frame each remote slot holds, -1 if none yet
+    int32_t remote_frame[LINK_HISTORY];
+    // checksum of state after each confirmed frame
+    uint16_t sums[LINK_HISTORY];
+    // latest remote input by frame, repeated for frames not yet received
+    LinkInput predicted;
+    int32_t predicted_frame;
+    // next frame to step
+    int32_t frame;
+    int32_t confirmed;
+    // every remote input below received is known
+    int32_t received;
+    // other board has every local input below remote_ack
+    int32_t remote_ack;
+    // earliest frame stepped with a wrong prediction, frame if none
+    int32_t rollback;
+    // last final state checksum sent by other board, checked once this
+    // board has final state of same frame
+    int32_t check_frame;
+    uint16_t check_sum;
+    bool check_pending;
+    // game over reported from final state
+    bool over_reported;
+    uint8_t side;
+    // packet being received
+    uint8_t rx[LINK_PACKET_MAX];
+    uint8_t rx_len;
+    LinkStats stats;
+} Link;
+
+void        link_init       (Link *k, uint8_t side);
+bool        link_step       (Link *k, Game *g, const LinkInput *local, uint16_t *events);
+uint8_t     link_encode     (Link *k, uint8_t *out);
+void        link_receive    (Link *k, const uint8_t *bytes, uint32_t length);
+uint16_t    link_checksum   (const Game *g);
+
+#endif /* _LINK_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
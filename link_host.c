@@ -0,0 +1,291 @@
+/*----------------------------------------------------------------------------
+* Filename:         link_host.c
+* Description:      Linux stand-in for a pong board in link play, steps game
+*                   through link with scripted paddle input over a serial
+*                   port or pty, and checks final state against the game
+*                   stepped directly with both scripts, not part of board
+*                   image
+*                   build: gcc -o link_host link_host.c link.c game.c
+*                          collide.c bricks.c fixed.c prof.c
+*                   run:   link_host          (two processes over a pty pair)
+*                          link_host top|bottom PATH [frames] [delay_ms]
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/wait.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "link.h"
+
+/*----------------------------------------------------------------------------
+ *      Host Constants
+ *---------------------------------------------------------------------------*/
+
+// host ticks are faster than board ticks so a test run is short, delay
+// is in ticks of link latency each way
+#define TICK_NS                 1000000L
+#define DEFAULT_FRAMES          5000
+#define DEFAULT_DELAY_MS        4
+// packets held back for delay, and run on after check so other side
+// still gets acknowledgements it needs
+#define QUEUE_PACKETS           64
+#define LINGER_TICKS            300
+// one packet in this many has a byte flipped to exercise framing
+#define CORRUPT_EVERY           97
+
+/*----------------------------------------------------------------------------
+ *      Host Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    int64_t due_ns;
+    uint8_t length;
+    uint8_t bytes[LINK_PACKET_MAX];
+} Pending;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+static Game     game;
+static Game     reference;
+static Link     game_link;
+static Pending  queue[QUEUE_PACKETS];
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      now_ns
+*   Author(s):          George Cowan
+*   Definition:         reads host monotonic clock
+*   Returns:            nanoseconds
+*******************************************************************************/
+static int64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*******************************************************************************
+*   Function Name:      script
+*   Author(s):          George Cowan
+*   Definition:         scripted input of one board, paddles sweep at
+                        different rates so predictions are often wrong,
+                        with an occasional press and a standing new match
+                        request that only acts once game is over
+*   Parameters:         side of board, frame
+*   Returns:            input of that board for frame
+*******************************************************************************/
+static LinkInput script(uint8_t side, int32_t f) {
+    LinkInput in;
+    int32_t range = PADDLE_Y_MAX - PADDLE_Y_MIN,
+            t = (f * (side == LINK_SIDE_TOP ? 3 : 5) + side * 41) % (2 * range);
+
+    in.paddle_y = PADDLE_Y_MIN + ((t < range) ? t : (2 * range - t));
+    in.speed_toggles = ((f % 701) == (side ? 350 : 0)) ? 1 : 0;
+    if ((f % 40) == (side ? 20 : 0)) {
+        in.speed_toggles |= LINK_NEW_MATCH;
+    }
+
+    return in;
+}
+
+/*******************************************************************************
+*   Function Name:      step_reference
+*   Author(s):          George Cowan
+*   Definition:         steps game directly with both scripts, same rules
+                        as link_simulate with every input known
+*   Parameters:         frames to step
+*******************************************************************************/
+static void step_reference(int32_t frames) {
+    LinkInput top,
+              bottom;
+    GameInput in;
+    int32_t f;
+
+    game_init(&reference, 1, true);
+    for (f = 0; f < frames; ++f) {
+        top = script(LINK_SIDE_TOP, f);
+        bottom = script(LINK_SIDE_BOTTOM, f);
+        in.paddle_top_y = top.paddle_y;
+        in.paddle_bottom_y = bottom.paddle_y;
+        in.speed_toggles = (top.speed_toggles & LINK_TOGGLES_MASK) +
+                           (bottom.speed_toggles & LINK_TOGGLES_MASK);
+        if (reference.over && ((top.speed_toggles | bottom.speed_toggles) & LINK_NEW_MATCH)) {
+            game_new_match(&reference);
+        }
+        game_step(&reference, &in);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      open_port
+*   Author(s):          George Cowan
+*   Definition:         opens serial port or pty non-blocking in raw mode
+*   Parameters:         path
+*   Returns:            file descriptor, -1 on failure
+*******************************************************************************/
+static int open_port(const char *path) {
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+
+    if (fd >= 0 && tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    return fd;
+}
+
+/*******************************************************************************
+*   Function Name:      run
+*   Author(s):          George Cowan
+*   Definition:         plays one side, one link step per tick, until final
+                        state of last frame is known, then compares it with
+                        reference
+*   Parameters:         side, open port, frames to check, one way delay
+*   Returns:            0 if final state matched and no desync was seen
+*******************************************************************************/
+static int run(uint8_t side, int fd, int32_t frames, int32_t delay_ms) {
+    const char *name = (side == LINK_SIDE_TOP) ? "top   " : "bottom";
+    uint8_t buf[256];
+    LinkInput local;
+    uint16_t events,
+             sum = 0,
+             expected;
+    uint32_t head = 0,
+             tail = 0,
+             sent = 0;
+    int32_t linger = -1;
+    int64_t next = now_ns();
+    ssize_t n;
+    Pending *p;
+    struct timespec ts;
+
+    game_init(&game, 1, true);
+    link_init(&game_link, side);
+    srand(side + 1);
+
+    while (linger != 0) {
+        while ((n = read(fd, buf, sizeof(buf))) > 0) {
+            link_receive(&game_link, buf, n);
+        }
+
+        local = script(side, game_link.frame);
+        link_step(&game_link, &game, &local, &events);
+
+        // checksum of frame is kept until it leaves history
+        if (linger < 0 && game_link.confirmed >= frames) {
+            sum = game_link.sums[(frames - 1) & (LINK_HISTORY - 1)];
+            linger = LINGER_TICKS;
+        }
+        else if (linger > 0) {
+            --linger;
+        }
+
+        if (head - tail < QUEUE_PACKETS) {
+            p = &queue[head++ % QUEUE_PACKETS];
+            p->length = link_encode(&game_link, p->bytes);
+            p->due_ns = now_ns() + (int64_t) delay_ms * 1000000;
+            if ((++sent % CORRUPT_EVERY) == 0) {
+                p->bytes[rand() % p->length] ^= 0x10;
+            }
+        }
+        while (tail != head && queue[tail % QUEUE_PACKETS].due_ns <= now_ns()) {
+            p = &queue[tail++ % QUEUE_PACKETS];
+            if (write(fd, p->bytes, p->length) < 0) {
+                // pty full, packet is lost like a dropped serial packet
+            }
+        }
+
+        next += TICK_NS;
+        ts.tv_sec = next / 1000000000LL;
+        ts.tv_nsec = next % 1000000000LL;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    }
+
+    step_reference(frames);
+    expected = link_checksum(&reference);
+
+    printf("%s frames %u stalls %u rollbacks %u resimulated %u max %u desyncs %u packets %u bad %u"
+           " | frame %d sum %04x expected %04x %s\n",
+           name, game_link.stats.frames, game_link.stats.stalls, game_link.stats.rollbacks,
+           game_link.stats.resimulated, game_link.stats.rollback_max, game_link.stats.desyncs,
+           game_link.stats.packets, game_link.stats.bad_packets, frames, sum, expected,
+           (sum == expected && game_link.stats.desyncs == 0) ? "ok" : "FAILED");
+    fflush(stdout);
+
+    return (sum == expected && game_link.stats.desyncs == 0) ? 0 : 1;
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         with no arguments opens a pty pair and plays both
+                        sides in two processes, otherwise plays one side on
+                        given port
+*   Returns:            0 if every side checked ok
+*******************************************************************************/
+int main(int argc, char **argv) {
+    int32_t frames = (argc > 3) ? atoi(argv[3]) : DEFAULT_FRAMES,
+            delay_ms = (argc > 4) ? atoi(argv[4]) : DEFAULT_DELAY_MS;
+    int master,
+        fd,
+        status,
+        result;
+    pid_t child;
+
+    if (argc > 2) {
+        fd = open_port(argv[2]);
+        if (fd < 0) {
+            perror(argv[2]);
+            return 1;
+        }
+        return run(strcmp(argv[1], "top") == 0 ? LINK_SIDE_TOP : LINK_SIDE_BOTTOM, fd, frames, delay_ms);
+    }
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) {
+        perror("pty");
+        return 1;
+    }
+    fcntl(master, F_SETFL, O_NONBLOCK);
+
+    child = fork();
+    if (child == 0) {
+        fd = open_port(ptsname(master));
+        return run(LINK_SIDE_BOTTOM, fd, frames, delay_ms);
+    }
+
+    // pty master has no line settings of its own
+    result = run(LINK_SIDE_TOP, master, frames, delay_ms);
+    waitpid(child, &status, 0);
+
+    return (result == 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
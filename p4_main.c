@@ -2,68 +2,114 @@
 * Filename:         p4_main.c
 * Description:      Two player game of pong, for use on a Keil MCB1700 board
 * Author(s):        George Cowan, Alexander Rathke
-* Date Modified:    Nov. 13, 2017
+* Date Modified:    Oct. 16, 2026
 *----------------------------------------------------------------------------*/
 #include <LPC17xx.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <math.h>
 #include <rtl.h>
 #include <stdbool.h>
 #include "uart.h"
 #include "led.h"
 #include "GLCD.h"
+#include "fixed.h"
 #include "point.h"
 #include "rect.h"
+#include "sprite.h"
 #include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "input.h"
+#include "record.h"
+#include "telemetry.h"
+#include "link.h"
+#include "ece_spi.h"
+#include "imu.h"
+#include "frame.h"
 #include "potentiometer.h"
 #include "joystick.h"
+#include "sampler.h"
+#include "tick.h"
+#include "prof.h"
+#include "timer.h"
 #include "utils.h"
 
 /*----------------------------------------------------------------------------
  *      Global Variables
  *---------------------------------------------------------------------------*/
 
+// Game state, stepped only by tsk_game, inputs written by paddle and
+// input tasks
+Game                    game;
+GameInput               game_input;
+
 // Ball
 const unsigned short    BALL_COLOR              =     Yellow;
-const uint8_t           BALL_DELAY              =     5;
-const uint8_t           DEFAULT_DIRECTION[2]    =     {4,3};
-const uint8_t           SPEED_ARRAY[2]          =     {7, 15};
-Ball                    main_ball;
-uint8_t                 ball_speed;
-uint8_t                 speed_index             =     0;
+// more than one plays multi-ball, up to BALL_SET_MAX
+const uint8_t           BALL_COUNT              =     1;
+// positions last reported to frame, only touched by tsk_game
+BallSet                 balls_old;
+
+// Bricks
+// true plays with walls of destructible bricks between paddles
+const bool              BRICK_MODE              =     false;
+const unsigned short    BRICK_COLOR             =     Olive;
 
 // Game logic
-const uint16_t          BORDER_WIDTH            =     10;
+// game tick period, same as one RTX tick that used to pace game
+const uint32_t          GAME_TICK_US            =     10000;
 const uint16_t          GAME_OVER_DELAY         =     250;
 const uint16_t          MAX_ACCEPTABLE_DELAY    =     0x2710;
-const uint8_t           MAX_SCORE               =     7;
+bool                    game_is_over            =     false;
 
-// Joystick
-const uint8_t           JOYSTICK_STEP           =     11;
+// Display
+const uint8_t           FRAME_DELAY             =     1;
 
-// Other
-const float             PI                      =     3.14159265;
+// Joystick
+const uint8_t           BOTTOM_PADDLE_DELAY     =     1;
+// joystick and push button samples per second, changes are posted to mailbox
+const uint16_t          INPUT_SAMPLE_HZ         =     1000;
+os_mbx_declare          (input_mbx, 16);
+
+// Input recording
+const uint8_t           RECORD_DELAY            =     10;
+
+// Telemetry
+// true sends a game state record per game frame on UART0 by DMA in place
+// of input recording and profiling dumps, tsk_record is not run and
+// joystick press does not ask for a dump, spans are still kept and can be
+// read from prof_spans with debugger
+const bool              TELEMETRY_MODE          =     false;
+
+// Link play
+// true plays against a second board over UART1, this board controls one
+// paddle and the other board's paddle arrives over link, input recording
+// then only covers this board's inputs and will not replay
+const bool              LINK_MODE               =     false;
+const uint8_t           LINK_SIDE               =     LINK_SIDE_BOTTOM;
+const uint32_t          LINK_PORT               =     1;
+// stepped only by tsk_game, new match asked for by tsk_game_over
+Link                    game_link;
+volatile bool           link_restart            =     false;
 
 // Paddles
 const unsigned short    PADDLE_BOTTOM_COLOR     =     Blue;
 const unsigned short    PADDLE_TOP_COLOR        =     Red;
-const uint16_t          PADDLE_HEIGHT           =     10;
-const uint16_t          PADDLE_OFFSET           =     15;
-const uint16_t          PADDLE_WIDTH            =     52;
 const uint8_t           TOP_PADDLE_DELAY        =     5;
-Rect                    paddle_top;
-Rect                    paddle_bottom;
 
-// Score
-uint16_t                top_score               =     0;
-uint16_t                bottom_score            =     0;
-bool                    game_is_over            =     false;
+// Tilt
+// true moves top paddle by tilting MPU-9250 on SSP0 in place of
+// potentiometer, sensor FIFO is drained once per poll
+const bool              TILT_MODE               =     false;
+const uint8_t           TILT_POLL_DELAY         =     1;
+// set from DMA interrupt when a sensor setup or drain has finished
+#define                 TILT_EVENT                    0x0001
+OS_TID                  tilt_task;
 
 // Mutex
 OS_MUT                  lcd_draw_mut;
 // Semaphores
-OS_SEM                  score_update_ready;
 OS_SEM                  signal_top_score;
 OS_SEM                  signal_bottom_score;
 OS_SEM                  signal_game_over;
@@ -78,18 +124,19 @@ void          display_init            ( void );
 void          wait_on_pb              ( void );
 void          show_score_page         ( void );
 void          init_objects            ( void );
-void          reset_ball              ( void );
-void          paddle_collision        ( Rect *);
-bool          calc_ball_position      ( uint16_t );
-void          EINT3_IRQHandler        ( void );
 void          redraw_paddles          ( void );
+uint16_t      link_exchange           ( uint8_t );
+void          tilt_ready              ( void * );
 
 __task  void  tsk_paddle_top          ( void );
 __task  void  tsk_paddle_bottom       ( void );
-__task  void  tsk_ball                ( void );
+__task  void  tsk_paddle_tilt         ( void );
+__task  void  tsk_game                ( void );
 __task  void  tsk_top_score           ( void );
 __task  void  tsk_bottom_score        ( void );
 __task  void  tsk_game_over           ( void );
+__task  void  tsk_record              ( void );
+__task  void  tsk_render              ( void );
 __task  void  start_tasks             ( void );
 
 int           main                    ( void );
@@ -140,13 +187,10 @@ void display_score( uint8_t score_left, uint8_t score_right ) {
 *   Definition:       draw walls on sides of LCD display
 *******************************************************************************/
 void draw_borders( void ) {
-    Rect border_left = new_rect(new_point(0,0), new_point(319,BORDER_WIDTH-1), DarkGrey);
-    Rect border_right = new_rect(new_point(0,240-BORDER_WIDTH), new_point(319,239), DarkGrey);
-
     os_mut_wait(&lcd_draw_mut, 0xFFFF);
 
-    draw_rect(&border_left);
-    draw_rect(&border_right);
+    draw_rect(&game.border_left);
+    draw_rect(&game.border_right);
 
     os_mut_release(&lcd_draw_mut);
 }
@@ -190,8 +234,8 @@ void show_score_page( void ) {
     char red[15],
     blue[15];
 
-    sprintf(red, "RED  - %d", top_score);
-    sprintf(blue, "BLUE - %d", bottom_score);
+    sprintf(red, "RED  - %d", game.top_score);
+    sprintf(blue, "BLUE - %d", game.bottom_score);
 
     GLCD_Clear(Black);
 
@@ -213,472 +257,366 @@ void show_score_page( void ) {
 /*******************************************************************************
 *   Function Name:    init_objects
 *   Author(s):        Alexander Rathke
-*   Definition:       defines objects (ball, paddles), clears score display
+*   Definition:       defines objects (ball, paddles, borders) and their
+                      colors, clears score display
 *******************************************************************************/
 void init_objects( void ) {
-    uint16_t center_y = ( (BORDER_WIDTH - 1) + (240 - BORDER_WIDTH) ) / 2,
-             center_x = 159,
-             paddle_left_y = center_y - (PADDLE_WIDTH/2);
+    game_init(&game, BALL_COUNT, BRICK_MODE);
+
+    game.paddle_bottom.color = PADDLE_BOTTOM_COLOR;
+    game.paddle_top.color = PADDLE_TOP_COLOR;
+    game.border_left.color = DarkGrey;
+    game.border_right.color = DarkGrey;
+    game.goal_bottom.color = Black;
+    game.goal_top.color = Black;
 
-    paddle_bottom = new_rect(new_point(PADDLE_OFFSET, paddle_left_y),
-                             new_point(PADDLE_OFFSET + PADDLE_HEIGHT, paddle_left_y + PADDLE_WIDTH),
-                             PADDLE_BOTTOM_COLOR);
-    paddle_top = new_rect(new_point(319 - PADDLE_OFFSET - PADDLE_HEIGHT, paddle_left_y),
-                          new_point(319 - PADDLE_OFFSET, paddle_left_y + PADDLE_WIDTH),
-                          PADDLE_TOP_COLOR);
+    game.balls.color = BALL_COLOR;
+    game.bricks.color = BRICK_COLOR;
 
-    main_ball = new_ball(new_point(center_x, center_y), BALL_COLOR);
-    generate_bitmap(&main_ball);
+    game_input.paddle_top_y = game.paddle_top.b_left.y;
+    game_input.paddle_bottom_y = game.paddle_bottom.b_left.y;
+    game_input.speed_toggles = 0;
 
     // set score display to empty (scores 0 at start)
-    display_score(top_score,bottom_score);
+    display_score(game.top_score, game.bottom_score);
 }
 
 /*******************************************************************************
-*   Function Name:    reset_ball
+*   Function Name:    redraw_paddles
 *   Author(s):        Alexander Rathke
-*   Definition:       resets ball to center position and default speed
+*   Definition:       redraws top and bottom paddle
 *******************************************************************************/
-void reset_ball( void ) {
-    uint16_t center_y = ( (BORDER_WIDTH - 1) + (240 - BORDER_WIDTH) ) / 2;
-    uint16_t center_x = 159;
-
-    ball_speed = SPEED_ARRAY[0];
-    speed_index = 0;
-
-    move_ball(&main_ball, new_point(center_x, center_y));
+void redraw_paddles( void ) {
+    draw_rect(&game.paddle_top);
+    draw_rect(&game.paddle_bottom);
 }
 
 /*******************************************************************************
-*   Function Name:    paddle_collision
+*   Function Name:    link_exchange
 *   Author(s):        George Cowan
-*   Definition:       calculate ball bounce angle with paddle
-*   Parameters:       paddle rectangle object
+*   Definition:       takes bytes received from other board, steps link
+                      once per tick due with this board's paddle, then
+                      sends unacknowledged inputs back, steps go on while
+                      game is over so a new match request gets through
+*   Parameters:       ticks due
+*   Returns:          GAME_EVENT bits from steps
 *******************************************************************************/
-void paddle_collision( Rect *paddle ) {
-    uint8_t min_angle = 15,
-            max_angle = 80;
-    float bounce_angle;
-    int8_t bounce_position = main_ball.center.y - floor((((paddle->b_left.y) + (paddle->t_right.y)) / 2)); //Relative position of ball, where 0 is center of paddle
-
-    //If only a portion of ball is in contact with paddle, bounce with minimum angle.
-    if (bounce_position > floor(PADDLE_WIDTH / 2)) {
-        bounce_position = floor(PADDLE_WIDTH / 2);
-    }
-    else if (bounce_position < -1 * floor(PADDLE_WIDTH / 2)) {
-        bounce_position = -1 * floor(PADDLE_WIDTH / 2);
+uint16_t link_exchange( uint8_t steps ) {
+    uint8_t packet[LINK_PACKET_MAX],
+            *data,
+            i;
+    uint32_t n;
+    uint16_t events = 0,
+             step_events;
+    GameInput input;
+    LinkInput local;
+
+    while ((n = UARTRxPeek(LINK_PORT, &data)) != 0) {
+        link_receive(&game_link, data, n);
+        UARTRxConsume(LINK_PORT, n);
     }
 
-    bounce_angle = (min_angle - max_angle) / (PADDLE_WIDTH / 2.0) * abs(bounce_position) + max_angle; //angle of velocity after bounce
-    bounce_angle = bounce_angle * PI / 180.0; //Convert to radians
+    for (i = 0; i < steps; ++i) {
+        __disable_irq();
+        input = game_input;
+        game_input.speed_toggles = 0;
+        record_sample(RECORD_TICK, input.speed_toggles);
+        __enable_irq();
 
-    if (bounce_position <= 0) { //bounce towards left side of screen
-        main_ball.velocity[1] = -1 * floor(ball_speed * cos(bounce_angle));
-    }
-    else { //bounce towards right side of screen
-        main_ball.velocity[1] = floor(ball_speed * cos(bounce_angle));
-    }
+        local.paddle_y = (LINK_SIDE == LINK_SIDE_TOP) ? input.paddle_top_y : input.paddle_bottom_y;
+        local.speed_toggles = input.speed_toggles & LINK_TOGGLES_MASK;
+        if (link_restart) {
+            local.speed_toggles |= LINK_NEW_MATCH;
+        }
 
-    if (main_ball.velocity[0] >= 0) { //moving upwards
-        main_ball.velocity[0] = -1 * ceil(ball_speed * sin(bounce_angle));
-    }
-    else { //moving downwards
-        main_ball.velocity[0] = ceil(ball_speed * sin(bounce_angle));
+        // a stalled step keeps its presses for next tick
+        if (!link_step(&game_link, &game, &local, &step_events)) {
+            __disable_irq();
+            game_input.speed_toggles += input.speed_toggles;
+            __enable_irq();
+        }
+        events |= step_events;
     }
+
+    n = link_encode(&game_link, packet);
+    UARTSend(LINK_PORT, packet, n);
+
+    return events;
 }
 
 /*******************************************************************************
-*   Function Name:    calc_ball_position
+*   Function Name:    tsk_paddle_top
 *   Author(s):        George Cowan
-*   Definition:       calculates next ball position
-*   Parameters:       ball move distance
-*   Returns:          bool true if goal occurs, false otherwise
+*   Definition:       task reading top paddle position from onboard
+                      potentiometer into game input, takes latest value
+                      filtered by ADC interrupt so reads never wait on a
+                      conversion
 *******************************************************************************/
-bool calc_ball_position ( uint16_t move_distance ) {
-    float scale_factor;
-    bool goal_scored = false;
-    /*
-    Special Move Cases
-    1) Hit Right Wall
-    2) Hit Left Wall
-    3) Current (center - radius) is below top of bottom paddle
-       1) if new position is between bounds of paddle & center is above top of paddle -> bounce
-       2) if new position is outside bounds of paddle & center is above top of paddle -> allow through
-       3) if new position is outside bounds of paddle & center is below top of paddle -> goal is scored
-    4) Pass Top of Bottom Paddle (current location is above paddle, next frame will be below paddle)
-       1) if new position is between bounds of paddle -> bounce
-       2) if new position is outside bounds of paddle & center is above top of paddle -> allow through
-       3) if new position is outside bounds of paddle & center is below top of paddle -> goal is scored
-    5) Current (center + radius) is above bottom of top paddle
-       1) if new position is between bounds of paddle & center is below bottom of paddle -> bounce
-       2) if new position is outside bounds of paddle & center is below bottom of paddle -> allow motion
-       3) if new position is outside bounds of paddle & center is above bottom of paddle -> goal is scored
-    6) Pass Bottom of Top Paddle (current location is below paddle, next frame will be below paddle)
-       1) if new position is between bounds of paddle -> bounce
-       2) if new position is outside bounds of paddle & center is below bottom of paddle -> allow through
-       3) if new position is outside bounds of paddle & center is above bottom of paddle -> goal is scored
-    */
-
-    if ((main_ball.center.y + main_ball.radius + main_ball.velocity[1]) > (239 - BORDER_WIDTH)) { //Bounce off right wall
-        //(distance moved) / (distance available)
-        scale_factor = ((239 - BORDER_WIDTH) - (main_ball.center.y + main_ball.radius)) / (main_ball.velocity[1]);
-
-        //Location of collison
-        shift_ball(&main_ball, floor(scale_factor * main_ball.velocity[0]),(239 - BORDER_WIDTH) - (main_ball.center.y + main_ball.radius));
-
-        //Update Velocity Vector
-        set_ball_velocity(&main_ball, main_ball.velocity[0], -1*main_ball.velocity[1]);
-
-    }
-    else if ((main_ball.center.y - main_ball.radius + main_ball.velocity[1]) < BORDER_WIDTH) { //Bounce off left wall
-        //(distance moved) / (distance available)
-        scale_factor = -1.0 * ((main_ball.center.y - main_ball.radius) - BORDER_WIDTH) / (main_ball.velocity[1]);
-
-        //Update Ball to location of collision
-        shift_ball(&main_ball, floor(scale_factor * main_ball.velocity[0]), main_ball.center.y - main_ball.radius - BORDER_WIDTH );
-
-        //Update Velocity Vector
-        set_ball_velocity(&main_ball, main_ball.velocity[0], -1*main_ball.velocity[1]);
-
-    }
-    else if ((main_ball.center.x - main_ball.radius) <= paddle_bottom.t_right.x) { //Current (center - radius) is below top of bottom paddle
-
-        // 1) if new position is between bounds of paddle & center is above top of paddle -> bounce
-        if (((main_ball.center.x + main_ball.velocity[0]) >= paddle_bottom.t_right.x) &&
-            ((main_ball.center.y - main_ball.radius) <= paddle_bottom.t_right.y)    &&
-            ((main_ball.center.y + main_ball.radius) >= paddle_bottom.b_left.y))    {
-
-            //shift ball up to collision location
-            shift_ball(&main_ball, main_ball.radius - (main_ball.center.x - paddle_bottom.t_right.x) + 1, 0);
-            //collide with paddle
-            paddle_collision(&paddle_bottom);
-        }
-        // 2) if new position is outside bounds of paddle & center is above top of paddle -> allow through
-        else if ((main_ball.center.x + main_ball.velocity[0]) > paddle_bottom.t_right.x) {
-
-            //move the ball the entire allowable distance
-          shift_ball(&main_ball, main_ball.velocity[0], main_ball.velocity[1]);
-          }
-        // 3) new center is below top of paddle -> goal is scored
-        else {
-                os_sem_send(&signal_top_score);
-                goal_scored = true;
-        }
-        }
-    else if ((main_ball.center.x - main_ball.radius + main_ball.velocity[0]) <= paddle_bottom.t_right.x ) { //Pass Top of Bottom Paddle (current location is above paddle, next frame will be below paddle)
-
-        // 1) if new position is between bounds of paddle -> bounce
-        if (((main_ball.center.y - main_ball.radius) <= paddle_bottom.t_right.y) &&
-            ((main_ball.center.y + main_ball.radius) >= paddle_bottom.b_left.y)) {
-
-            //scale factor
-            scale_factor = -1.0 * (main_ball.center.x - main_ball.radius - paddle_bottom.t_right.x) / main_ball.velocity[0];
-
-            //Update ball to location of collision
-            shift_ball(&main_ball, main_ball.center.x - main_ball.radius - paddle_bottom.t_right.x + 1, floor(scale_factor * main_ball.velocity[1]));
+__task void tsk_paddle_top( void ) {
+    uint16_t pot_val,
+             pot_val_old = 0xFFFF;
 
-            //Update velocity vector
-            paddle_collision(&paddle_bottom);
-        }
-        //2) new position is outside bounds of paddle & center is above top of paddle -> allow through
-        else if ((main_ball.center.x - main_ball.radius + main_ball.velocity[0]) > paddle_bottom.t_right.x){
-            //move the ball the entire allowable distance
-            shift_ball(&main_ball, main_ball.velocity[0], main_ball.velocity[1]);
-        }
-        //3) new position is outside bounds of paddle & center is below top of paddle -> goal is scored
-        else {
-            os_sem_send(&signal_top_score);
-            goal_scored = true;
-        }
+    // ADC converts in background, first filtered value is ready after
+    // POTENTIOMETER_OVERSAMPLE conversions
+    potentiometer_burst_setup();
+    while (potentiometer_updates() == 0) {
+        os_dly_wait(1);
     }
-    else if ((main_ball.center.x + main_ball.radius) >= paddle_top.b_left.x) { //Current (center + radius) is above bottom of top paddle
 
-        //1) if new position is between bounds of paddle & center is below bottom of paddle -> bounce
-        if (((main_ball.center.x + main_ball.velocity[0]) <= paddle_top.b_left.x) &&
-           ((main_ball.center.y - main_ball.radius) <= paddle_top.t_right.y)      &&
-           ((main_ball.center.y + main_ball.radius) >= paddle_top.b_left.y)) {
-
-            //shift ball down to collision location
-            shift_ball(&main_ball, (-1 * ((main_ball.center.x + main_ball.radius) - (paddle_top.b_left.x - main_ball.center.x))) - 1,0);
-            //collide with paddle
-            paddle_collision(&paddle_top);
+    while(1) {
+        if(!game_is_over) {
+            pot_val = potentiometer_latest();
+
+            // same reading maps to same paddle position, only changes are
+            // recorded and applied together so replay sees same order
+            if (pot_val != pot_val_old) {
+                __disable_irq();
+                record_sample(RECORD_POT, pot_val);
+                input_pot(&game_input, pot_val);
+                __enable_irq();
+                pot_val_old = pot_val;
+            }
 
+            os_dly_wait(TOP_PADDLE_DELAY);
         }
-        //2) new position is outside bounds of paddle & center is below bottom of paddle -> allow motion
-        else if ((main_ball.center.x + main_ball.velocity[0]) < paddle_top.b_left.x) {
-            //move the ball the entire allowable distance
-            shift_ball(&main_ball, main_ball.velocity[0], main_ball.velocity[1]);
-        }
-        //3) new position is outside bounds of paddle & center is above bottom of paddle -> goal is scored
         else {
-            os_sem_send(&signal_bottom_score);
-            goal_scored = true;
+            os_tsk_pass();
         }
-    }
-    else if ((main_ball.center.x + main_ball.radius + main_ball.velocity[0]) >= paddle_top.b_left.x) { //Pass Bottom of Top Paddle (current location is below paddle, next frame will be above paddle)
-
-        // 1) if new position is between bounds of paddle -> bounce
-        if (((main_ball.center.y - main_ball.radius) <= paddle_top.t_right.y) &&
-            ((main_ball.center.y + main_ball.radius) >= paddle_top.b_left.y)) {
-
-            //scale factor
-            scale_factor = (paddle_top.b_left.x - (main_ball.center.x + main_ball.radius)) / main_ball.velocity[0];
-
-            //Update ball to location of collision
-            shift_ball(&main_ball, paddle_top.b_left.x - main_ball.center.x - main_ball.radius - 1, floor(scale_factor * main_ball.velocity[1]));
-
-            //Update velocity vector
-            paddle_collision(&paddle_top);
 
-        }
-        // 2) new position is outside bounds of paddle & center is below bottom of paddle -> allow through
-        else if ((main_ball.center.x + main_ball.radius + main_ball.velocity[0]) < paddle_bottom.b_left.x){
-            //move the ball the entire allowable distance
-            shift_ball(&main_ball, main_ball.velocity[0], main_ball.velocity[1]);
-        }
-        // 3) new position is outside bounds of paddle & center is above bottom of paddle -> goal is scored
-        else {
-            os_sem_send(&signal_bottom_score);
-            goal_scored = true;
-        }
-    }
-    else { //No collision occurs -> only move
-        shift_ball(&main_ball, main_ball.velocity[0], main_ball.velocity[1]);
     }
-    return goal_scored;
 }
 
 /*******************************************************************************
-*   Function Name:    EINT3_IRQHandler
+*   Function Name:    tilt_ready
 *   Author(s):        George Cowan
-*   Definition:       IRQ handler for push button, cycles ball speed
+*   Definition:       imu callback, runs in DMA interrupt, wakes tilt task
+*   Parameters:       unused
 *******************************************************************************/
-void EINT3_IRQHandler ( void ) {
-    LPC_GPIOINT->IO2IntClr |= (1 << 10);
-    speed_index = (speed_index + 1) % 2; //incrementIndex
-    ball_speed = SPEED_ARRAY[speed_index]; //incrementSpeed
+void tilt_ready( void *context ) {
+    isr_evt_set(TILT_EVENT, tilt_task);
 }
 
 /*******************************************************************************
-*   Function Name:    redraw_paddles
-*   Author(s):        Alexander Rathke
-*   Definition:       redraws top and bottom paddle
-*******************************************************************************/
-void redraw_paddles( void ) {
-    draw_rect(&paddle_top);
-    draw_rect(&paddle_bottom);
-}
-
-/*******************************************************************************
-*   Function Name:    tsk_paddle_top
+*   Function Name:    tsk_paddle_tilt
 *   Author(s):        George Cowan
-*   Definition:       task managing top paddle position, controlled by
-                      onboard potentiometer
+*   Definition:       task moving top paddle by board tilt, drains sensor
+                      FIFO at a fixed rate and filters every sample, CPU
+                      only sets up two transfers per poll, falls back to
+                      potentiometer if sensor does not answer
 *******************************************************************************/
-__task void tsk_paddle_top( void ) {
-    uint16_t pot_val,
-             bottom_left_y,
-             bottom_left_y_old,
-             b_left_range = (239 - BORDER_WIDTH - PADDLE_WIDTH) - (BORDER_WIDTH),
-             pot_min = 100, //any value less than this maps to max bottom_left_y pixel value
-             pot_max = 4000, //value maps to min bottom_left_y pixel value
-             pot_range = pot_max - pot_min;
-    float step_size = pot_range / b_left_range, //change in potentiometer reading to move paddle 1 pixel
-          step_edge;
-    uint8_t hysteresis_size = 10;
-
-    // For drawing
-    OS_RESULT wait_result;
-    Rect paddle_top_old = paddle_top;
-    Rect subtractor;
-
-    potentiometer_setup();
-
-    // Initial draw
-    draw_rect(&paddle_top);
-
+__task void tsk_paddle_tilt( void ) {
+    ImuFilter filter;
+    const uint8_t *fifo;
+    uint32_t length;
+    uint16_t y,
+             y_old = 0xFFFF;
+
+    tilt_task = os_tsk_self();
+    imu_start(tilt_ready, 0);
+    while (imu_state == IMU_CONFIGURING) {
+        os_evt_wait_or(TILT_EVENT, 0xFFFF);
+    }
+    if (imu_state != IMU_RUNNING) {
+        os_tsk_create(tsk_paddle_top, 1);
+        os_tsk_delete_self();
+    }
 
-    //initial poteniometer read - old values for first loop.
-    pot_val = potentiometer_read();
-    bottom_left_y_old = (uint16_t)ceil((-1.0*b_left_range/pot_range)*pot_val + BORDER_WIDTH + (1.0*pot_max*b_left_range/pot_range));
+    imu_filter_init(&filter, game_input.paddle_top_y);
+    os_itv_set(TILT_POLL_DELAY);
 
     while(1) {
-        if(!game_is_over) {
-            pot_val = potentiometer_read();
-
-            // only allow potentiometer values within max and min range.
-            if (pot_val > pot_max) {
-                pot_val = pot_max;
-            }
-            else if (pot_val < pot_min) {
-                pot_val = pot_min;
-            }
-
-            bottom_left_y = (uint16_t)ceil((-1.0*b_left_range/pot_range)*pot_val + BORDER_WIDTH + (1.0*pot_max*b_left_range/pot_range));
-
-
-            if (abs(bottom_left_y - bottom_left_y_old) == 1) {
-                //Special Case: Paddle was against right border
-                if ((bottom_left_y_old == (BORDER_WIDTH + b_left_range)) && (pot_val < (pot_min + hysteresis_size))) {
-                    bottom_left_y = bottom_left_y_old;
-                }
-                //All other cases (except special case: No hysteresis if moving into right border)
-                else if (!((bottom_left_y_old == (BORDER_WIDTH + b_left_range - 1)) && (pot_val <= pot_min))) {
-                    //edge of old range
-                    step_edge = (-1.0*pot_range*bottom_left_y_old/b_left_range) + (BORDER_WIDTH*pot_range/b_left_range) + pot_max;
-
-                    //keep old value if not outside hysteresis zone
-                    if (pot_val < ceil(step_edge + hysteresis_size) && pot_val > floor(step_edge - step_size - hysteresis_size)) {
-                        bottom_left_y = bottom_left_y_old;
-                    }
-                }
-            }
-            bottom_left_y_old = bottom_left_y;
-
-            rect_set_points(&paddle_top, new_point(319-PADDLE_OFFSET-PADDLE_HEIGHT, bottom_left_y), new_point(319-PADDLE_OFFSET, bottom_left_y + PADDLE_WIDTH));
-
-            // Draw updated top paddle
-            wait_result = os_mut_wait(&lcd_draw_mut, MAX_ACCEPTABLE_DELAY);
-            if (wait_result != OS_R_TMO) {
-              if (!rect_is_pos_equal(&paddle_top, &paddle_top_old)) {
-                  subtractor = subtract_rect_y(&paddle_top_old, &paddle_top, Black);
-                  draw_rect(&paddle_top);
-                  draw_rect(&subtractor);
-                  paddle_top_old = paddle_top;
-              }
-              os_mut_release(&lcd_draw_mut);
-            }
-            os_dly_wait(TOP_PADDLE_DELAY);
-        }
-        else {
-            os_tsk_pass();
+        os_itv_wait();
+        // a drain that outran its wait must not wake next one early
+        os_evt_clr(TILT_EVENT, tilt_task);
+        if (imu_poll()) {
+            os_evt_wait_or(TILT_EVENT, TILT_POLL_DELAY);
         }
 
+        // filter keeps up while game is over, so paddle is where board
+        // is tilted when next match starts
+        length = imu_read(&fifo);
+        y = imu_filter(&filter, fifo, length);
+        if (!game_is_over && y != y_old) {
+            __disable_irq();
+            record_sample(RECORD_TILT, y);
+            input_tilt(&game_input, y);
+            __enable_irq();
+            y_old = y;
+        }
     }
 }
 
 /*******************************************************************************
 *   Function Name:    tsk_paddle_bottom
 *   Author(s):        Alexander Rathke
-*   Definition:       task managing bottom paddle position, controlled by
-                      joystick
+*   Definition:       task applying joystick and push button changes posted
+                      by input sampler to game input, blocks while controls
+                      are idle, pressing joystick in asks for profiling dump
 *******************************************************************************/
 __task void tsk_paddle_bottom( void ) {
-    uint32_t pos;
-    // maximum position limits
-    uint16_t right_lim = (240 - BORDER_WIDTH - JOYSTICK_STEP),
-             left_lim = (BORDER_WIDTH - 1 + JOYSTICK_STEP);
-    Rect paddle_bottom_old = paddle_bottom,
-         subtractor;
-    OS_RESULT wait_result;
+    void *msg;
+    uint32_t state,
+             last,
+             pos;
+    uint16_t timeout = 0xFFFF;
 
-    // initialize joystick
-    joystick_setup();
+    sampler_start(input_mbx, INPUT_SAMPLE_HZ);
 
-    // initial draw
-    draw_rect(&paddle_bottom);
+    // sampler posts state it starts with
+    os_mbx_wait(input_mbx, &msg, 0xFFFF);
+    state = (uint32_t) msg;
+    last = state;
 
     while(1) {
-        if(!game_is_over) {
-            // read joystick, calc values
-            pos = joystick_read();
+        // wakes on changed input, or to step a held joystick again
+        if (os_mbx_wait(input_mbx, &msg, timeout) != OS_R_TMO) {
+            state = (uint32_t) msg;
+        }
+        pos = state & SAMPLER_JOYSTICK_MASK;
 
-            if (pos == 32 || pos == 33) {
-                // move right
-                if (paddle_bottom.t_right.y < right_lim) {
-                    shift_rect_y(&paddle_bottom, JOYSTICK_STEP);
-                }
-                else if (paddle_bottom.t_right.y < (240-BORDER_WIDTH) - 1) {
-                // if close to limit, shift to max position
-                    shift_rect_y(&paddle_bottom, (240-BORDER_WIDTH - 1) - paddle_bottom.t_right.y);
-                }
-            }
-            else if (pos == 8 || pos == 9) {
-                // move left
-                if (paddle_bottom.b_left.y > left_lim) {
-                    shift_rect_y(&paddle_bottom, -1*JOYSTICK_STEP);
-                }
-                else if (paddle_bottom.b_left.y > BORDER_WIDTH) {
-                    shift_rect_y(&paddle_bottom, BORDER_WIDTH - paddle_bottom.b_left.y);
-                }
+        if(!game_is_over) {
+            // recorded and applied together so replay sees same order
+            __disable_irq();
+            if ((state & SAMPLER_BUTTON_DOWN) && !(last & SAMPLER_BUTTON_DOWN)) {
+                record_sample(RECORD_BUTTON, 0);
+                input_button(&game_input);
             }
-
-            // Draw updated lower paddle if mut acquired before timeout
-            wait_result = os_mut_wait(&lcd_draw_mut, MAX_ACCEPTABLE_DELAY);
-
-            if (wait_result != OS_R_TMO) {
-                if (!rect_is_pos_equal(&paddle_bottom, &paddle_bottom_old)) {
-                    // clears non-overlapping part of old paddle position
-                    subtractor = subtract_rect_y(&paddle_bottom_old, &paddle_bottom, Black);
-                    draw_rect(&paddle_bottom);
-                    draw_rect(&subtractor);
-                    paddle_bottom_old = paddle_bottom;
-                }
-                os_mut_release(&lcd_draw_mut);
+            if (pos & (JOY_UP | JOY_DOWN)) {
+                record_sample(RECORD_JOYSTICK, pos);
+                input_joystick(&game_input, pos);
             }
+            __enable_irq();
         }
-        os_tsk_pass();
+        // dump is polled by tsk_record, which telemetry mode does not run
+        if (!TELEMETRY_MODE && (pos & JOY_PRESS) && !(last & JOY_PRESS)) {
+            prof_dump_requested = true;
+        }
+        last = state;
+
+        // paddle speed is not bounded by draw time, held joystick steps
+        // explicitly, otherwise task sleeps until input changes
+        timeout = (pos & (JOY_UP | JOY_DOWN)) ? BOTTOM_PADDLE_DELAY : 0xFFFF;
     }
 }
 
 /*******************************************************************************
-*   Function Name:    tsk_ball
+*   Function Name:    tsk_game
 *   Author(s):        George Cowan, Alexander Rathke
-*   Definition:       task managing ball position
+*   Definition:       steps game once per TIMER0 tick with latest inputs,
+                      passes score events to scoring tasks and reports moved
+                      objects for next frame, budget used per tick and ticks
+                      missed waiting on LCD are kept in tick_stats
+                      in telemetry mode each stepped frame is also sent
+                      in link mode game is stepped through link, which may
+                      roll back and step again frames predicted wrongly
 *******************************************************************************/
-__task void tsk_ball( void ) {
-    Ball main_ball_old = deep_copy_ball(&main_ball),
-         subtractor;
-    bool goal_scored = false,
-         game_was_over = false;
+__task void tsk_game( void ) {
+    // only positions of old objects are used
+    Rect paddle_top_old = game.paddle_top,
+         paddle_bottom_old = game.paddle_bottom;
+    GameInput input;
+    uint16_t events = 0;
+    uint8_t i,
+            steps;
+    bool game_was_over = false;
     OS_RESULT wait_result;
 
-    reset_ball();
+    balls_old = game.balls;
+    tick_start(os_tsk_self(), GAME_TICK_US);
 
     // initial draw
-    draw_ball(&main_ball);
-    set_ball_velocity(&main_ball,DEFAULT_DIRECTION[0],DEFAULT_DIRECTION[1]);
+    os_mut_wait(&lcd_draw_mut, 0xFFFF);
+    for (i = 0; i < game.balls.count; ++i) {
+        frame_mark_circle(game.balls.x[i], game.balls.y[i], game.balls.radius[i]);
+    }
+    frame_mark_rect(&game.paddle_top);
+    frame_mark_rect(&game.paddle_bottom);
+    frame_mark_bricks(&game.bricks);
+    os_mut_release(&lcd_draw_mut);
 
     while(1) {
+        // game steps once per timer tick, ticks that fell due while task
+        // was busy are stepped now so motion keeps its speed
+        steps = tick_wait();
+
         if(!game_is_over) {
             if (game_was_over) {
                 os_dly_wait(GAME_OVER_DELAY);
+                tick_skip();
                 game_was_over = false;
+                continue;
             }
 
-            goal_scored = calc_ball_position(ball_speed);
-
-            if (goal_scored) {
-                os_sem_wait(&score_update_ready, 0xFFFF);
+            events = 0;
+            if (LINK_MODE) {
+                events = link_exchange(steps);
+            }
+            else {
+                for (i = 0; i < steps; ++i) {
+                    // push button presses are counted by sampler, tick is
+                    // recorded with presses taken so replay steps on same input
+                    __disable_irq();
+                    input = game_input;
+                    game_input.speed_toggles = 0;
+                    record_sample(RECORD_TICK, input.speed_toggles);
+                    __enable_irq();
+
+                    events |= game_step(&game, &input);
+                }
             }
 
-            // draw updated ball
-            wait_result = os_mut_wait(&lcd_draw_mut, MAX_ACCEPTABLE_DELAY);
-
-            if (wait_result != OS_R_TMO) {
-                if (!ball_is_pos_equal(&main_ball_old, &main_ball)) {
-                    free_bitmap(&subtractor);
-                    copy_bitmap(&main_ball, &main_ball_old);
+            if (TELEMETRY_MODE) {
+                telemetry_send(&game, timer_read());
+            }
 
-                    subtractor = subtract_ball(&main_ball_old, &main_ball, Black);
+            if (events & GAME_EVENT_TOP_SCORE) {
+                os_sem_send(&signal_top_score);
+            }
+            if (events & GAME_EVENT_BOTTOM_SCORE) {
+                os_sem_send(&signal_bottom_score);
+            }
+            if (events & GAME_EVENT_GAME_OVER) {
+                os_sem_send(&signal_game_over);
+            }
 
-                    // clear non-overlapping portion of old ball position
-                    draw_ball(&subtractor);
-                    draw_ball(&main_ball);
+            // report old and new area of moved objects
+            wait_result = tick_mut_wait(&lcd_draw_mut, MAX_ACCEPTABLE_DELAY);
 
-                    // update old ball location
-                    main_ball_old.center = main_ball.center;
+            if (wait_result != OS_R_TMO) {
+                if (!rect_is_pos_equal(&game.paddle_top, &paddle_top_old)) {
+                    frame_mark_rect(&paddle_top_old);
+                    frame_mark_rect(&game.paddle_top);
+                    paddle_top_old = game.paddle_top;
+                }
+                if (!rect_is_pos_equal(&game.paddle_bottom, &paddle_bottom_old)) {
+                    frame_mark_rect(&paddle_bottom_old);
+                    frame_mark_rect(&game.paddle_bottom);
+                    paddle_bottom_old = game.paddle_bottom;
                 }
+                for (i = 0; i < game.balls.count; ++i) {
+                    if (balls_old.x[i] == game.balls.x[i] && balls_old.y[i] == game.balls.y[i]) {
+                        continue;
+                    }
+                    // old position is repainted from whatever lies beneath
+                    frame_mark_circle_move(balls_old.x[i], balls_old.y[i],
+                                           game.balls.x[i], game.balls.y[i], game.balls.radius[i]);
+                    balls_old.x[i] = game.balls.x[i];
+                    balls_old.y[i] = game.balls.y[i];
+                }
+                // destroyed bricks, or all of them after a new match
+                frame_mark_bricks(&game.bricks);
                 os_mut_release(&lcd_draw_mut);
             }
 
-            // limit ball update speed, otherwise paddle movement significantly
-            // slows ball movement speed
-            os_dly_wait(BALL_DELAY);
+            tick_done();
         }
         else {
+            // other board still needs acknowledgements, and a new match
+            // may be asked for by either board
+            if (LINK_MODE) {
+                link_exchange(steps);
+            }
             game_was_over = true;
-            os_tsk_pass();
         }
     }
 }
@@ -686,26 +624,14 @@ __task void tsk_ball( void ) {
 /*******************************************************************************
 *   Function Name:    tsk_top_score
 *   Author(s):        Alexander Rathke
-*   Definition:       updates top paddle score on semaphore signal received
+*   Definition:       shows top paddle score on semaphore signal received
 *******************************************************************************/
 __task void tsk_top_score( void ) {
     while(1) {
         os_sem_wait(&signal_top_score, 0xFFFF);
 
-        ++top_score;
-
         draw_borders();
-        display_score(top_score, bottom_score);
-
-        if ( top_score == MAX_SCORE) {
-            os_sem_send(&signal_game_over);
-        }
-
-        reset_ball();
-        set_ball_velocity(&main_ball,DEFAULT_DIRECTION[0],DEFAULT_DIRECTION[1]);
-
-        // signal ready to receive another score update
-        os_sem_send(&score_update_ready);
+        display_score(game.top_score, game.bottom_score);
 
         os_tsk_pass();
     }
@@ -714,26 +640,14 @@ __task void tsk_top_score( void ) {
 /*******************************************************************************
 *   Function Name:    tsk_bottom_score
 *   Author(s):        Alexander Rathke
-*   Definition:       updates bottom paddle score on semaphore signal received
+*   Definition:       shows bottom paddle score on semaphore signal received
 *******************************************************************************/
 __task void tsk_bottom_score( void ) {
     while(1) {
         os_sem_wait(&signal_bottom_score, 0xFFFF);
 
-        ++bottom_score;
-
         draw_borders();
-        display_score(top_score, bottom_score);
-
-        if ( bottom_score == MAX_SCORE ) {
-            os_sem_send(&signal_game_over);
-        }
-
-        reset_ball();
-        set_ball_velocity(&main_ball, -1 * DEFAULT_DIRECTION[0],DEFAULT_DIRECTION[1]);
-
-        // signal ready to receive another score update
-        os_sem_send(&score_update_ready);
+        display_score(game.top_score, game.bottom_score);
 
         os_tsk_pass();
     }
@@ -743,7 +657,8 @@ __task void tsk_bottom_score( void ) {
 *   Function Name:    tsk_game_over
 *   Author(s):        Alexander Rathke
 *   Definition:       responds to game over signal, shows score page until
-                      push button pressed to start new game
+                      push button pressed to start new game, in link mode
+                      until either board's press has started it
 *******************************************************************************/
 __task void tsk_game_over( void ) {
     uint8_t i;
@@ -752,45 +667,91 @@ __task void tsk_game_over( void ) {
         os_sem_wait(&signal_game_over, 0xFFFF);
         game_is_over = true;
 
-        erase_ball(&main_ball, Black);
+        // waits for any frame in progress, no frames flushed after this
+        os_mut_wait(&lcd_draw_mut, 0xFFFF);
+        erase_ball_set(&game.balls, Black);
+        os_mut_release(&lcd_draw_mut);
 
         // flash LEDs
         for(i = 0; i < 6; ++i) {
             display_score(0, 0);
             os_dly_wait(16);
-            display_score(top_score, bottom_score);
+            display_score(game.top_score, game.bottom_score);
             os_dly_wait(16);
         }
 
-        // prevent push button from registering as ball speed change
-        __disable_irq();
-
-        show_score_page();
-        // waits on push button press and release to start a new game
-        wait_on_pb();
-
-        __enable_irq();
-
-        // reset display for new game
+        if (LINK_MODE) {
+            show_score_page();
+            // a press on either board starts new match on both, game keeps
+            // stepping through link, so wait for it to leave game over
+            while (game.over) {
+                if (!is_bit_on(LPC_GPIO2->FIOPIN, 10)) {
+                    link_restart = true;
+                }
+                os_dly_wait(1);
+            }
+            link_restart = false;
+        }
+        else {
+            // input task ignores push button while game is over, so press
+            // that ends wait is not taken as a speed change
+            show_score_page();
+            // waits on push button press and release to start a new game
+            wait_on_pb();
+
+            // reset score and display for new game
+            __disable_irq();
+            record_sample(RECORD_NEW_MATCH, 0);
+            game_new_match(&game);
+            __enable_irq();
+        }
         GLCD_Clear(Black);
         draw_borders();
-        reset_ball();
         redraw_paddles();
-
-        // reset score
-        top_score = 0;
-        bottom_score = 0;
-        display_score(top_score, bottom_score);
+        display_score(game.top_score, game.bottom_score);
 
         game_is_over = false;
         os_tsk_pass();
     }
 }
 
+/*******************************************************************************
+*   Function Name:    tsk_record
+*   Author(s):        George Cowan
+*   Definition:       streams recorded input out over UART0, and profiling
+                      dump when asked for between record chunks
+*******************************************************************************/
+__task void tsk_record( void ) {
+    while(1) {
+        record_flush();
+        prof_poll();
+        os_dly_wait(RECORD_DELAY);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:    tsk_render
+*   Author(s):        Alexander Rathke
+*   Definition:       repaints regions reported by object tasks once per frame,
+                      so overlapping objects are only sent to LCD once
+*******************************************************************************/
+__task void tsk_render( void ) {
+    while(1) {
+        os_mut_wait(&lcd_draw_mut, 0xFFFF);
+        if (!game_is_over) {
+            frame_flush();
+        }
+        os_mut_release(&lcd_draw_mut);
+
+        os_dly_wait(FRAME_DELAY);
+    }
+}
+
 /*******************************************************************************
 *   Function Name:    start_tasks
 *   Author(s):        George Cowan, Alexander Rathke
-*   Definition:       init mutex and semaphores, draw borders, start tasks
+*   Definition:       init mutex and semaphores, draw borders, build frame
+                      scene, start tasks
 *******************************************************************************/
 __task void start_tasks( void ) {
     // control LCD screen access, maintain consistent color
@@ -799,40 +760,73 @@ __task void start_tasks( void ) {
     os_sem_init(&signal_top_score, 0);
     os_sem_init(&signal_bottom_score, 0);
     os_sem_init(&signal_game_over, 0);
-    os_sem_init(&score_update_ready, 0);
+    os_mbx_init(input_mbx, sizeof(input_mbx));
 
     // draw walls of display
     draw_borders();
 
-    // object tasks
-    os_tsk_create(tsk_paddle_top, 1);
+    // scene layers, back to front
+    frame_add_rect(&game.border_left);
+    frame_add_rect(&game.border_right);
+    frame_add_rect(&game.paddle_top);
+    frame_add_rect(&game.paddle_bottom);
+    frame_add_bricks(&game.bricks);
+    frame_add_ball_set(&game.balls);
+
+    // input tasks
+    if (TILT_MODE) {
+        os_tsk_create(tsk_paddle_tilt, 1);
+    }
+    else {
+        os_tsk_create(tsk_paddle_top, 1);
+    }
     os_tsk_create(tsk_paddle_bottom, 1);
-    os_tsk_create(tsk_ball, 1);
+
+    // game task
+    os_tsk_create(tsk_game, 1);
 
     // scoring tasks
     os_tsk_create(tsk_bottom_score, 1);
     os_tsk_create(tsk_top_score, 1);
     os_tsk_create(tsk_game_over, 1);
 
+    // display task
+    os_tsk_create(tsk_render, 1);
+
+    // input log, UART0 belongs to DMA in telemetry mode
+    if (!TELEMETRY_MODE) {
+        os_tsk_create(tsk_record, 1);
+    }
+
     os_tsk_delete_self();
 }
 
 /*******************************************************************************
 *   Function Name:    main
 *   Author(s):        George Cowan, Alexander Rathke
-*   Definition:       init system, config push button interrupt, run program
+*   Definition:       init system, run program
 *******************************************************************************/
 int main( void ) {
     SystemInit();
+    prof_init();
+    timer_setup();
+    UARTInit(0, 115200);
+    if (TELEMETRY_MODE) {
+        telemetry_start();
+    }
+    if (LINK_MODE) {
+        UARTInit(LINK_PORT, 115200);
+    }
+    if (TILT_MODE) {
+        SPI_setup();
+        SPI_asyncSetup();
+    }
     init_objects();
+    record_start(BALL_COUNT, BRICK_MODE);
+    // both boards start from same state, so frames line up
+    link_init(&game_link, LINK_SIDE);
     display_init();
 
-    // push button interrupt config
-    LPC_PINCON->PINSEL4 &= ~( 3 << 20 );
-    LPC_GPIO2->FIODIR &= ~( 1 << 10 );
-    LPC_GPIOINT->IO2IntEnF |= (1 << 10 );
-    NVIC_EnableIRQ( EINT3_IRQn );
-
     os_sys_init(start_tasks);
 
     while(1);
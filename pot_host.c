@@ -0,0 +1,215 @@
+/*----------------------------------------------------------------------------
+* Filename:         pot_host.c
+* Description:      Linux check of potentiometer table mapping against float
+*                   mapping it replaced, runs every 12-bit reading from every
+*                   previous top paddle position through both and counts
+*                   positions that differ, then times both in ns per
+*                   sample, not part of board image
+*                   host has an FPU, board does not and runs float through
+*                   library calls, so host timings understate board gain
+*                   build: gcc -O2 -DPROF_ENABLED=0 -o pot_host pot_host.c
+*                          input.c prof.c -lm
+*                   run:   pot_host [timing passes]
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "input.h"
+
+/*----------------------------------------------------------------------------
+ *      Check Constants
+ *---------------------------------------------------------------------------*/
+
+#define READINGS                4096
+#define DEFAULT_PASSES          20
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+// keeps optimizer from dropping timed mappings
+static volatile uint32_t sink;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      now_ns
+*   Author(s):          George Cowan
+*   Definition:         reads monotonic clock
+*   Returns:            nanoseconds
+*******************************************************************************/
+static uint64_t now_ns(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t) t.tv_sec * 1000000000u) + t.tv_nsec;
+}
+
+/*******************************************************************************
+*   Function Name:      pot_float
+*   Author(s):          George Cowan
+*   Definition:         float mapping input_pot used before tables, kept
+                        as it was so table can be checked against it
+*   Parameters:         game input (top paddle modified), 12-bit reading
+*******************************************************************************/
+static void pot_float(GameInput *in, uint16_t pot_val) {
+    uint16_t bottom_left_y,
+             bottom_left_y_old = in->paddle_top_y,
+             b_left_range = (239 - BORDER_WIDTH - PADDLE_WIDTH) - (BORDER_WIDTH),
+             pot_min = 100, //any value less than this maps to max bottom_left_y pixel value
+             pot_max = 4000, //value maps to min bottom_left_y pixel value
+             pot_range = pot_max - pot_min;
+    float step_size = pot_range / b_left_range, //change in potentiometer reading to move paddle 1 pixel
+          step_edge;
+    uint8_t hysteresis_size = 10;
+
+    // only allow potentiometer values within max and min range.
+    if (pot_val > pot_max) {
+        pot_val = pot_max;
+    }
+    else if (pot_val < pot_min) {
+        pot_val = pot_min;
+    }
+
+    bottom_left_y = (uint16_t)ceil((-1.0*b_left_range/pot_range)*pot_val + BORDER_WIDTH + (1.0*pot_max*b_left_range/pot_range));
+
+    if (abs(bottom_left_y - bottom_left_y_old) == 1) {
+        //Special Case: Paddle was against right border
+        if ((bottom_left_y_old == (BORDER_WIDTH + b_left_range)) && (pot_val < (pot_min + hysteresis_size))) {
+            bottom_left_y = bottom_left_y_old;
+        }
+        //All other cases (except special case: No hysteresis if moving into right border)
+        else if (!((bottom_left_y_old == (BORDER_WIDTH + b_left_range - 1)) && (pot_val <= pot_min))) {
+            //edge of old range
+            step_edge = (-1.0*pot_range*bottom_left_y_old/b_left_range) + (BORDER_WIDTH*pot_range/b_left_range) + pot_max;
+
+            //keep old value if not outside hysteresis zone
+            if (pot_val < ceil(step_edge + hysteresis_size) && pot_val > floor(step_edge - step_size - hysteresis_size)) {
+                bottom_left_y = bottom_left_y_old;
+            }
+        }
+    }
+
+    in->paddle_top_y = bottom_left_y;
+}
+
+/*******************************************************************************
+*   Function Name:      check
+*   Author(s):          George Cowan
+*   Definition:         maps every reading from every paddle position both
+                        ways and prints first few that differ
+*   Parameters:         number of cases run (modified)
+*   Returns:            number of cases that differ
+*******************************************************************************/
+static uint32_t check(uint32_t *cases) {
+    GameInput a = { 0, 0, 0 },
+              b = { 0, 0, 0 };
+    uint32_t mismatches = 0;
+    uint16_t y,
+             v;
+
+    *cases = 0;
+    for (y = PADDLE_Y_MIN; y <= PADDLE_Y_MAX; ++y) {
+        for (v = 0; v < READINGS; ++v) {
+            a.paddle_top_y = y;
+            b.paddle_top_y = y;
+            pot_float(&a, v);
+            input_pot(&b, v);
+            ++*cases;
+            if (a.paddle_top_y != b.paddle_top_y) {
+                if (mismatches < 10) {
+                    printf("paddle at %u, reading %u: float %u, table %u\n", y, v,
+                           a.paddle_top_y, b.paddle_top_y);
+                }
+                ++mismatches;
+            }
+        }
+    }
+    return mismatches;
+}
+
+/*******************************************************************************
+*   Function Name:      ns_per_sample
+*   Author(s):          George Cowan
+*   Definition:         times one mapping over every reading from every
+                        paddle position, best pass is kept
+*   Parameters:         passes, true to time float mapping
+*   Returns:            nanoseconds per sample
+*******************************************************************************/
+static double ns_per_sample(uint32_t passes, bool use_float) {
+    GameInput in = { 0, 0, 0 };
+    uint64_t start,
+             best = 0;
+    uint32_t p,
+             sum;
+    uint16_t y,
+             v;
+
+    for (p = 0; p < passes; ++p) {
+        sum = 0;
+        start = now_ns();
+        for (y = PADDLE_Y_MIN; y <= PADDLE_Y_MAX; ++y) {
+            for (v = 0; v < READINGS; ++v) {
+                in.paddle_top_y = y;
+                if (use_float) {
+                    pot_float(&in, v);
+                }
+                else {
+                    input_pot(&in, v);
+                }
+                sum += in.paddle_top_y;
+            }
+        }
+        start = now_ns() - start;
+        if (p == 0 || start < best) {
+            best = start;
+        }
+        sink += sum;
+    }
+    return (double) best / ((PADDLE_Y_MAX - PADDLE_Y_MIN + 1) * READINGS);
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         checks table against float mapping and times both
+*   Parameters:         timing passes
+*   Returns:            0 if every case matched
+*******************************************************************************/
+int main(int argc, char **argv) {
+    uint32_t passes = (argc > 1) ? (uint32_t) atoi(argv[1]) : DEFAULT_PASSES,
+             cases,
+             mismatches;
+
+    if (passes == 0) {
+        return 1;
+    }
+
+    mismatches = check(&cases);
+    printf("positions %u to %u, %u readings each\n", PADDLE_Y_MIN, PADDLE_Y_MAX, READINGS);
+    printf("mismatches %u of %u %s\n", mismatches, cases, mismatches == 0 ? "ok" : "FAILED");
+    printf("float ns/sample %8.2f\n", ns_per_sample(passes, true));
+    printf("table ns/sample %8.2f\n", ns_per_sample(passes, false));
+
+    return mismatches == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
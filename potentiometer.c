@@ -21,3 +21,43 @@ uint32_t potentiometer_read(void) {
 		os_tsk_pass();                     // make sure other tasks can run
 	return (LPC_ADC->ADGDR >> 4) & 0xFFF;  // read and return 12-bit result
 }
+
+// Burst mode support
+
+// shared with ADC_IRQHandler, each is a single aligned word written only by
+// the interrupt, so readers need no lock
+static volatile uint32_t pot_filtered = 0;
+static volatile uint32_t pot_updates = 0;
+static uint32_t pot_sum = 0;
+static uint32_t pot_count = 0;
+
+void potentiometer_burst_setup(void) {
+	LPC_PINCON->PINSEL1 &= ~(3<<18);      // P0.25 is GPIO
+	LPC_PINCON->PINSEL1 |=  (1<<18);      // P0.25 is AD0.2
+	LPC_SC->PCONP       |=  (1<<12);      // enable power to ADC block
+	LPC_ADC->ADINTEN     =  (1<< 2);      // interrupt on AD0.2 done only
+	LPC_ADC->ADCR        =  (1<< 2) |     // select AD0.2 pin
+	                        (255<< 8) |   // ADC clock is 25MHz/256, about 1500 conversions/s
+	                        (1<<16) |     // burst mode, START bits stay 0
+	                        (1<<21);      // enable ADC
+	NVIC_EnableIRQ(ADC_IRQn);
+}
+
+void ADC_IRQHandler(void) {
+	uint32_t result = LPC_ADC->ADDR2;     // reading clears DONE and the interrupt
+	pot_sum += (result >> 4) & 0xFFF;
+	if (++pot_count == POTENTIOMETER_OVERSAMPLE) {   // decimate: one value per block
+		pot_filtered = pot_sum / POTENTIOMETER_OVERSAMPLE;
+		++pot_updates;
+		pot_sum = 0;
+		pot_count = 0;
+	}
+}
+
+uint32_t potentiometer_latest(void) {
+	return pot_filtered;
+}
+
+uint32_t potentiometer_updates(void) {
+	return pot_updates;
+}
@@ -4,3 +4,12 @@
 
 void potentiometer_setup(void);
 uint32_t potentiometer_read(void);  // returns a value in range 0..4095
+
+// Burst mode: AD0.2 converts continuously, conversion-done interrupt
+// averages POTENTIOMETER_OVERSAMPLE readings into one filtered value
+
+#define POTENTIOMETER_OVERSAMPLE 16   // power of two
+
+void potentiometer_burst_setup(void);
+uint32_t potentiometer_latest(void);  // latest filtered value, 0..4095, never blocks
+uint32_t potentiometer_updates(void); // filtered values produced so far
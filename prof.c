@@ -0,0 +1,275 @@
+/*----------------------------------------------------------------------------
+* Filename:         prof.c
+* Description:      Profiling spans timed by DWT cycle counter for pong on
+*                   Keil MCB1700 board, builds on host against a monotonic
+*                   nanosecond clock so both sets of numbers can be compared
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#ifdef __CC_ARM
+#include <lpc17xx.h>
+#include <rtl.h>
+#include "uart.h"
+#else
+#include <time.h>
+#endif
+#include "prof.h"
+
+/*----------------------------------------------------------------------------
+ *      Profiling Constants
+ *---------------------------------------------------------------------------*/
+
+#ifdef __CC_ARM
+// Cortex-M3 debug registers, cycle counter runs only with trace enabled
+#define DEMCR                   (*(volatile uint32_t *) 0xE000EDFC)
+#define DWT_CTRL                (*(volatile uint32_t *) 0xE0001000)
+#define DWT_CYCCNT              (*(volatile uint32_t *) 0xE0001004)
+#define DEMCR_TRCENA            (1u << 24)
+#define DWT_CTRL_CYCCNTENA      (1u << 0)
+#define PROF_UNIT               "cycles"
+// dump shares UART0 with record stream, written between record chunks
+#define PROF_PORT               0
+#else
+#define PROF_UNIT               "ns"
+#endif
+
+#define PROF_LINE               96
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+ProfSpan prof_spans[PROF_SPANS];
+volatile bool prof_dump_requested = false;
+
+// cost of an empty span, taken off every time so short spans read true
+static uint32_t         prof_overhead = 0;
+
+static const char *const PROF_NAMES[PROF_SPANS] = {
+    "game_step",
+    "ball_move",
+    "paddle_collision",
+    "frame_compose",
+    "frame_blit",
+    "draw_rect",
+    "erase_ball_set",
+    "input_pot",
+    "frame_flush"
+};
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      prof_write
+*   Author(s):          George Cowan
+*   Definition:         writes one line of dump text, on target waits for
+                        room on TX ring so dump is never dropped
+*   Parameters:         null terminated text
+*******************************************************************************/
+static void prof_write(const char *line) {
+#ifdef __CC_ARM
+    uint32_t n = 0;
+
+    while (line[n] != '\0') {
+        ++n;
+    }
+    while (UARTTxFree(PROF_PORT) < n) {
+        os_dly_wait(1);
+    }
+    UARTSend(PROF_PORT, (uint8_t *) line, n);
+#else
+    fputs(line, stdout);
+#endif
+}
+
+/*******************************************************************************
+*   Function Name:      prof_bucket
+*   Author(s):          George Cowan
+*   Definition:         finds histogram bucket of a time, buckets double in
+                        width so one table covers a few cycles up to whole
+                        ticks
+*   Parameters:         time of span
+*   Returns:            bucket index, below PROF_BUCKETS
+*******************************************************************************/
+static uint8_t prof_bucket(uint32_t t) {
+    uint8_t b = 0;
+
+    t >>= PROF_BUCKET_SHIFT - 1;
+    while (t > 1 && b < (PROF_BUCKETS - 1)) {
+        t >>= 1;
+        ++b;
+    }
+
+    return b;
+}
+
+/*******************************************************************************
+*   Function Name:      prof_init
+*   Author(s):          George Cowan
+*   Definition:         starts cycle counter and clears every span, measures
+                        cost of an empty span to take off later times
+*******************************************************************************/
+void prof_init(void) {
+    uint32_t start;
+
+#ifdef __CC_ARM
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+#endif
+
+    start = prof_now();
+    prof_overhead = prof_now() - start;
+
+    prof_reset();
+}
+
+/*******************************************************************************
+*   Function Name:      prof_reset
+*   Author(s):          George Cowan
+*   Definition:         clears every span, times taken before this are lost
+*******************************************************************************/
+void prof_reset(void) {
+    uint8_t i,
+            b;
+
+    for (i = 0; i < PROF_SPANS; ++i) {
+        prof_spans[i].count = 0;
+        prof_spans[i].min = 0xFFFFFFFF;
+        prof_spans[i].max = 0;
+        prof_spans[i].total = 0;
+        for (b = 0; b < PROF_BUCKETS; ++b) {
+            prof_spans[i].buckets[b] = 0;
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      prof_now
+*   Author(s):          George Cowan
+*   Definition:         reads free running time, wraps so only differences
+                        shorter than one wrap are meaningful (about 42 s on
+                        target, 4 s on host)
+*   Returns:            cycles on target, nanoseconds on host
+*******************************************************************************/
+uint32_t prof_now(void) {
+#ifdef __CC_ARM
+    return DWT_CYCCNT;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) ((uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec);
+#endif
+}
+
+/*******************************************************************************
+*   Function Name:      prof_end
+*   Author(s):          George Cowan
+*   Definition:         adds time since start to span, time includes any
+                        nested spans and any task or interrupt that ran in
+                        between, update is atomic so spans may end in any
+                        task or with interrupts already disabled
+*   Parameters:         span index, time from PROF_BEGIN
+*******************************************************************************/
+void prof_end(uint8_t span, uint32_t start) {
+    uint32_t t = prof_now() - start;
+    ProfSpan *s = &prof_spans[span];
+#ifdef __CC_ARM
+    uint32_t masked;
+#endif
+
+    t = (t > prof_overhead) ? (t - prof_overhead) : 0;
+
+#ifdef __CC_ARM
+    // interrupts stay disabled if caller had them disabled
+    masked = __get_PRIMASK();
+    __disable_irq();
+#endif
+
+    ++s->count;
+    s->total += t;
+    if (t < s->min) {
+        s->min = t;
+    }
+    if (t > s->max) {
+        s->max = t;
+    }
+    ++s->buckets[prof_bucket(t)];
+
+#ifdef __CC_ARM
+    if (!masked) {
+        __enable_irq();
+    }
+#endif
+}
+
+/*******************************************************************************
+*   Function Name:      prof_dump
+*   Author(s):          George Cowan
+*   Definition:         writes every span as text, one summary line and one
+                        histogram line each, over UART0 on target and to
+                        stdout on host, spans keep counting
+*******************************************************************************/
+void prof_dump(void) {
+    char line[PROF_LINE];
+    ProfSpan s;
+    uint8_t i,
+            b;
+    int n;
+
+    sprintf(line, "PROF %s overhead %lu\r\n", PROF_UNIT, (unsigned long) prof_overhead);
+    prof_write(line);
+
+    for (i = 0; i < PROF_SPANS; ++i) {
+        // copy so a span ending part way through is not torn
+#ifdef __CC_ARM
+        __disable_irq();
+        s = prof_spans[i];
+        __enable_irq();
+#else
+        s = prof_spans[i];
+#endif
+        if (s.count == 0) {
+            continue;
+        }
+
+        sprintf(line, "%-16s n %lu min %lu mean %lu max %lu\r\n", PROF_NAMES[i],
+                (unsigned long) s.count, (unsigned long) s.min,
+                (unsigned long) (s.total / s.count), (unsigned long) s.max);
+        prof_write(line);
+
+        // bucket counts, lowest first
+        n = sprintf(line, "%-16s", "");
+        for (b = 0; b < PROF_BUCKETS; ++b) {
+            n += sprintf(line + n, " %lu", (unsigned long) s.buckets[b]);
+            if (n > PROF_LINE - 16) {
+                break;
+            }
+        }
+        sprintf(line + n, "\r\n");
+        prof_write(line);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      prof_poll
+*   Author(s):          George Cowan
+*   Definition:         dumps spans if a dump was requested, called from task
+                        that owns UART0 so dump does not split a record chunk
+*******************************************************************************/
+void prof_poll(void) {
+    if (prof_dump_requested) {
+        prof_dump_requested = false;
+        prof_dump();
+    }
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,74 @@
+/*----------------------------------------------------------------------------
+* Filename:         prof.h
+* Description:      Profiling spans timed by DWT cycle counter for pong on
+*                   Keil MCB1700 board, builds on host against a monotonic
+*                   nanosecond clock so both sets of numbers can be compared
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _PROF_H
+#define _PROF_H
+
+// 0 compiles every span down to nothing
+#ifndef PROF_ENABLED
+#define PROF_ENABLED            1
+#endif
+
+// histogram buckets per span, bucket 0 holds times below
+// 1 << PROF_BUCKET_SHIFT, bucket n holds times with highest set bit
+// n + PROF_BUCKET_SHIFT - 1, last bucket holds everything longer
+#define PROF_BUCKETS            16
+#define PROF_BUCKET_SHIFT       4
+
+// timed spans, one slot each, compose and blit are each burst of a
+// frame_flush, so they add up to most of it
+#define PROF_GAME_STEP          0
+#define PROF_BALL_MOVE          1
+#define PROF_PADDLE_COLLISION   2
+#define PROF_FRAME_COMPOSE      3
+#define PROF_FRAME_BLIT         4
+#define PROF_DRAW_RECT          5
+#define PROF_ERASE_BALL_SET     6
+#define PROF_INPUT_POT          7
+#define PROF_FRAME_FLUSH        8
+#define PROF_SPANS              9
+
+typedef struct {
+    /*
+    times of one span, cycles on target and
+    nanoseconds on host, total is wide enough
+    for hours of 100 MHz cycles
+    */
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t buckets[PROF_BUCKETS];
+} ProfSpan;
+
+#if PROF_ENABLED
+// start time is taken into a local declared by the span
+#define PROF_BEGIN(start)       ((start) = prof_now())
+#define PROF_END(span, start)   prof_end((span), (start))
+#else
+#define PROF_BEGIN(start)       ((start) = 0)
+#define PROF_END(span, start)   ((void) (start))
+#endif
+
+extern ProfSpan prof_spans[PROF_SPANS];
+// set to have next prof_poll write out every span, only polled when
+// UART0 is not given to telemetry DMA
+extern volatile bool prof_dump_requested;
+
+void        prof_init       (void);
+void        prof_reset      (void);
+uint32_t    prof_now        (void);
+void        prof_end        (uint8_t span, uint32_t start);
+void        prof_dump       (void);
+void        prof_poll       (void);
+
+#endif /* _PROF_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
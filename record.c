@@ -0,0 +1,133 @@
+/*----------------------------------------------------------------------------
+* Filename:         record.c
+* Description:      Timestamped input recorder for pong on Keil MCB1700
+*                   board, samples are kept in a RAM ring and streamed out
+*                   over UART0 for replay
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <lpc17xx.h>
+#include <stdbool.h>
+#include "uart.h"
+#include "timer.h"
+#include "record.h"
+
+/*----------------------------------------------------------------------------
+ *      Record Constants
+ *---------------------------------------------------------------------------*/
+
+#define RECORD_PORT             0
+// samples sent per UART write
+#define RECORD_CHUNK            16
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+uint32_t record_dropped = 0;
+
+static Sample               record_ring[RECORD_SLOTS];
+// free running, slot is count % RECORD_SLOTS, head written by producers
+// and tail by the one consumer
+static volatile uint32_t    record_head = 0;
+static volatile uint32_t    record_tail = 0;
+static uint8_t              record_seq = 0;
+
+static Sample               record_chunk[RECORD_CHUNK];
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      record_start
+*   Author(s):          George Cowan
+*   Definition:         empties ring and writes start marker, call once game
+                        is initialized and before input is sampled
+*   Parameters:         number of balls and brick mode game was initialized
+                        with
+*******************************************************************************/
+void record_start(uint8_t ball_count, bool brick_mode) {
+    record_head = 0;
+    record_tail = 0;
+    record_seq = 0;
+    record_dropped = 0;
+    record_sample(RECORD_START, (RECORD_VERSION << 8) | (brick_mode ? RECORD_START_BRICKS : 0) | ball_count);
+}
+
+/*******************************************************************************
+*   Function Name:      record_sample
+*   Author(s):          George Cowan
+*   Definition:         stamps sample with microsecond timer and appends it
+                        to ring, counted as dropped if ring is full
+                        not reentrant, call with interrupts disabled, so
+                        sample order matches the order input reaches the
+                        game, button presses come from the RIT sampler
+                        through the input task like joystick moves
+*   Parameters:         sample source, value
+*******************************************************************************/
+void record_sample(uint8_t source, uint16_t value) {
+    Sample *s;
+
+    if (record_head - record_tail >= RECORD_SLOTS) {
+        ++record_dropped;
+        // seq still advances so reader sees the gap
+        ++record_seq;
+        return;
+    }
+
+    s = &record_ring[record_head % RECORD_SLOTS];
+    s->time_us = timer_read();
+    s->value = value;
+    s->source = source;
+    s->seq = record_seq++;
+
+    ++record_head;
+}
+
+/*******************************************************************************
+*   Function Name:      record_drain
+*   Author(s):          George Cowan
+*   Definition:         copies oldest samples out of ring, single consumer
+                        only, safe against producers without locking
+*   Parameters:         destination, most samples to take
+*   Returns:            number of samples copied
+*******************************************************************************/
+uint32_t record_drain(Sample *out, uint32_t max) {
+    uint32_t head = record_head,
+             n = 0;
+
+    while (record_tail != head && n < max) {
+        out[n++] = record_ring[record_tail % RECORD_SLOTS];
+        ++record_tail;
+    }
+
+    return n;
+}
+
+/*******************************************************************************
+*   Function Name:      record_flush
+*   Author(s):          George Cowan
+*   Definition:         queues samples recorded so far on UART0 as raw
+                        samples, only as many as fit on TX ring, the rest
+                        wait in record ring for next flush
+*******************************************************************************/
+void record_flush(void) {
+    uint32_t n,
+             max;
+
+    do {
+        max = UARTTxFree(RECORD_PORT) / sizeof(Sample);
+        if (max > RECORD_CHUNK) {
+            max = RECORD_CHUNK;
+        }
+        n = record_drain(record_chunk, max);
+        if (n > 0) {
+            UARTSend(RECORD_PORT, (uint8_t *) record_chunk, n * sizeof(Sample));
+        }
+    } while (n == RECORD_CHUNK);
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
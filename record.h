@@ -0,0 +1,51 @@
+/*----------------------------------------------------------------------------
+* Filename:         record.h
+* Description:      Timestamped input recorder for pong on Keil MCB1700
+*                   board, samples are kept in a RAM ring and streamed out
+*                   over UART0 for replay
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _RECORD_H
+#define _RECORD_H
+
+// ring size in samples, must be a power of two
+#define RECORD_SLOTS            256
+#define RECORD_VERSION          4
+// set in start value if game plays with bricks
+#define RECORD_START_BRICKS     0x80
+
+// sample sources, value meaning in brackets
+#define RECORD_START            0   // (RECORD_VERSION << 8 | RECORD_START_BRICKS | ball count) recording began,
+                                    // game just initialized
+#define RECORD_POT              1   // (12-bit reading) top paddle potentiometer
+#define RECORD_JOYSTICK         2   // (joystick_read bits) bottom paddle joystick
+#define RECORD_BUTTON           3   // (0) push button press seen by RIT sampler
+#define RECORD_TICK             4   // (speed toggles consumed) game stepped
+#define RECORD_NEW_MATCH        5   // (0) match restarted after game over
+#define RECORD_TILT             6   // (paddle y) top paddle tilt sensor, filtered
+
+typedef struct {
+    /*
+    one input event, 8 bytes little endian on the wire,
+    seq counts up by one per sample so gaps show drops
+    */
+    uint32_t time_us;
+    uint16_t value;
+    uint8_t source;
+    uint8_t seq;
+} Sample;
+
+// samples lost because ring was full
+extern uint32_t record_dropped;
+
+void        record_start    (uint8_t ball_count, bool brick_mode);
+void        record_sample   (uint8_t source, uint16_t value);
+uint32_t    record_drain    (Sample *out, uint32_t max);
+void        record_flush    (void);
+
+#endif /* _RECORD_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
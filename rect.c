@@ -2,14 +2,16 @@
 * Filename:         rect.c
 * Description:      Rectangle object, used for paddle and wall representation
 * Author(s):        George Cowan, Alexander Rathke
-* Date Modified:    Nov. 13, 2017
+* Date Modified:    Oct. 16, 2026
 *----------------------------------------------------------------------------*/
-#include <lpc17xx.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include "point.h"
 #include "GLCD.h"
+#include "sprite.h"
 #include "rect.h"
+#include "prof.h"
 
 /*----------------------------------------------------------------------------
  *      Function Definitions
@@ -91,6 +93,7 @@ bool rect_is_pos_equal(Rect *a, Rect*b) {
 *******************************************************************************/
 Rect subtract_rect_y(Rect *old, Rect *next, unsigned short clear_color) {
     Rect non_overlap = (*old);
+
     non_overlap.color = clear_color;
 
     if ((old->t_right.y > next->b_left.y) && (old->b_left.y < next->b_left.y)){
@@ -132,18 +135,18 @@ void shift_rect_y(Rect *r, int16_t shift_y) {
 /*******************************************************************************
 *   Function Name:      draw_rect
 *   Author(s):          Alexander Rathke
-*   Definition:         draws rectangle on LCD
+*   Definition:         draws rectangle on LCD as a solid windowed fill
 *   Parameters:         rectangle to draw
 *******************************************************************************/
 void draw_rect(Rect *r) {
-    uint16_t i, j;
-    GLCD_SetTextColor(r->color);
+    uint32_t prof_start;
 
-    for (i = r->b_left.x; i <= r->t_right.x; ++i) {
-        for(j = r->b_left.y; j <= r->t_right.y; ++j) {
-            GLCD_PutPixel(i,j);
-        }
-    }
+    PROF_BEGIN(prof_start);
+    sprite_fill(r->b_left.x, r->b_left.y,
+                r->t_right.x - r->b_left.x + 1,
+                r->t_right.y - r->b_left.y + 1,
+                r->color);
+    PROF_END(PROF_DRAW_RECT, prof_start);
 }
 
 /******************************************************************************
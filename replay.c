@@ -0,0 +1,78 @@
+/*----------------------------------------------------------------------------
+* Filename:         replay.c
+* Description:      Feeds recorded input back into pong game core, builds on
+*                   host for running recorded matches faster than real time
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "input.h"
+#include "record.h"
+#include "replay.h"
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      replay_run
+*   Author(s):          George Cowan
+*   Definition:         applies recorded samples to game in order, stepping
+                        game on each tick sample, so game ends in the state
+                        it had on the board
+                        log may be split across calls, game and input carry
+                        state between them
+                        timestamps are not used, replay runs as fast as the
+                        game core steps
+*   Parameters:         game (modified), input (modified), samples, number
+                        of samples
+*   Returns:            number of game steps taken
+*******************************************************************************/
+uint32_t replay_run(Game *g, GameInput *in, const Sample *log, uint32_t count) {
+    uint32_t i,
+             steps = 0;
+
+    for (i = 0; i < count; ++i) {
+        if (log[i].source == RECORD_START) {
+            game_init(g, log[i].value & (RECORD_START_BRICKS - 1), (log[i].value & RECORD_START_BRICKS) != 0);
+            in->paddle_top_y = g->paddle_top.b_left.y;
+            in->paddle_bottom_y = g->paddle_bottom.b_left.y;
+            in->speed_toggles = 0;
+        }
+        else if (log[i].source == RECORD_POT) {
+            input_pot(in, log[i].value);
+        }
+        else if (log[i].source == RECORD_JOYSTICK) {
+            input_joystick(in, log[i].value);
+        }
+        else if (log[i].source == RECORD_TILT) {
+            input_tilt(in, log[i].value);
+        }
+        else if (log[i].source == RECORD_TICK) {
+            // presses are counted when game takes them, button samples only
+            // mark when they happened
+            in->speed_toggles = (uint8_t) log[i].value;
+            game_step(g, in);
+            in->speed_toggles = 0;
+            ++steps;
+        }
+        else if (log[i].source == RECORD_NEW_MATCH) {
+            game_new_match(g);
+        }
+    }
+
+    return steps;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
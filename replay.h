@@ -0,0 +1,17 @@
+/*----------------------------------------------------------------------------
+* Filename:         replay.h
+* Description:      Feeds recorded input back into pong game core, builds on
+*                   host for running recorded matches faster than real time
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _REPLAY_H
+#define _REPLAY_H
+
+uint32_t    replay_run      (Game *g, GameInput *in, const Sample *log, uint32_t count);
+
+#endif /* _REPLAY_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
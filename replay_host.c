@@ -0,0 +1,379 @@
+/*----------------------------------------------------------------------------
+* Filename:         replay_host.c
+* Description:      Linux replay of a recording streamed by record.c, decodes
+*                   8 byte little endian samples from a capture file, runs
+*                   them through replay_run as fast as game core steps and
+*                   prints final game state and its link checksum, so a
+*                   board match can be checked and studied off the board,
+*                   can also write a recording of a scripted match to check
+*                   replay against, not part of board image
+*                   build: gcc -O2 -DPROF_ENABLED=0 -o replay_host
+*                          replay_host.c replay.c input.c link.c game.c
+*                          collide.c bricks.c fixed.c prof.c
+*                   run:   replay_host FILE
+*                          replay_host -w FILE [ticks] [seed]
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "input.h"
+#include "record.h"
+#include "replay.h"
+#include "link.h"
+
+/*----------------------------------------------------------------------------
+ *      Replay Constants
+ *---------------------------------------------------------------------------*/
+
+#define SAMPLE_BYTES            8
+#define SOURCES                 (RECORD_TILT + 1)
+// replay passes timed, best is kept
+#define PASSES                  3
+// balls printed in final state
+#define BALLS_SHOWN             4
+
+// scripted match written by -w, same tick as board
+#define DEFAULT_TICKS           100000
+#define TICK_US                 10000
+// ticks between joystick samples and chance in ticks of a speed press
+#define JOYSTICK_PERIOD         5
+#define PRESS_CHANCE            3000
+#define POT_MIN                 100
+#define POT_MAX                 4000
+// pot reading noise and paddle aim error
+#define POT_NOISE               30
+#define AIM_ERROR               30
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+static const char *SOURCE_NAMES[SOURCES] = {
+    "start", "pot", "joystick", "button", "tick", "new match", "tilt"
+};
+
+static Game             game;
+static GameInput        input;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      now_ns
+*   Author(s):          George Cowan
+*   Definition:         reads monotonic clock
+*   Returns:            nanoseconds
+*******************************************************************************/
+static uint64_t now_ns(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t) t.tv_sec * 1000000000u) + t.tv_nsec;
+}
+
+/*******************************************************************************
+*   Function Name:      decode
+*   Author(s):          George Cowan
+*   Definition:         unpacks one sample from wire bytes, so host byte
+                        order and struct padding do not matter
+*   Parameters:         wire bytes, sample to fill
+*******************************************************************************/
+static void decode(const uint8_t *b, Sample *s) {
+    s->time_us = (uint32_t) b[0] | ((uint32_t) b[1] << 8) |
+                 ((uint32_t) b[2] << 16) | ((uint32_t) b[3] << 24);
+    s->value = (uint16_t) (b[4] | (b[5] << 8));
+    s->source = b[6];
+    s->seq = b[7];
+}
+
+/*******************************************************************************
+*   Function Name:      encode
+*   Author(s):          George Cowan
+*   Definition:         packs one sample into wire bytes as board sends it
+*   Parameters:         sample, wire bytes to fill
+*******************************************************************************/
+static void encode(const Sample *s, uint8_t *b) {
+    b[0] = (uint8_t) s->time_us;
+    b[1] = (uint8_t) (s->time_us >> 8);
+    b[2] = (uint8_t) (s->time_us >> 16);
+    b[3] = (uint8_t) (s->time_us >> 24);
+    b[4] = (uint8_t) s->value;
+    b[5] = (uint8_t) (s->value >> 8);
+    b[6] = s->source;
+    b[7] = s->seq;
+}
+
+/*******************************************************************************
+*   Function Name:      load
+*   Author(s):          George Cowan
+*   Definition:         reads every whole sample of a capture file, a torn
+                        sample at end is dropped
+*   Parameters:         path, number of samples (modified)
+*   Returns:            samples, NULL if file could not be read
+*******************************************************************************/
+static Sample *load(const char *path, uint32_t *count) {
+    FILE *f = fopen(path, "rb");
+    Sample *log = NULL,
+           *grown;
+    uint8_t b[SAMPLE_BYTES];
+    uint32_t size = 0;
+
+    *count = 0;
+    if (f == NULL) {
+        return NULL;
+    }
+    while (fread(b, 1, SAMPLE_BYTES, f) == SAMPLE_BYTES) {
+        if (*count == size) {
+            size = (size == 0) ? 4096 : (2 * size);
+            grown = realloc(log, size * sizeof(Sample));
+            if (grown == NULL) {
+                free(log);
+                fclose(f);
+                return NULL;
+            }
+            log = grown;
+        }
+        decode(b, &log[(*count)++]);
+    }
+    fclose(f);
+
+    return (log == NULL) ? malloc(sizeof(Sample)) : log;
+}
+
+/*******************************************************************************
+*   Function Name:      put
+*   Author(s):          George Cowan
+*   Definition:         writes one sample of scripted match, numbered as
+                        record_sample numbers them
+*   Parameters:         file, time, source, value
+*******************************************************************************/
+static void put(FILE *f, uint32_t time_us, uint8_t source, uint16_t value) {
+    static uint8_t seq = 0;
+    Sample s;
+    uint8_t b[SAMPLE_BYTES];
+
+    s.time_us = time_us;
+    s.value = value;
+    s.source = source;
+    s.seq = seq++;
+    encode(&s, b);
+    fwrite(b, 1, SAMPLE_BYTES, f);
+}
+
+/*******************************************************************************
+*   Function Name:      write_match
+*   Author(s):          George Cowan
+*   Definition:         plays a scripted match as board tasks would record
+                        it, top paddle follows first ball by potentiometer,
+                        bottom paddle by joystick, speed button pressed now
+                        and then, and writes samples to file
+*   Parameters:         path, ticks, random seed
+*   Returns:            0 if file was written
+*******************************************************************************/
+static int write_match(const char *path, uint32_t ticks, uint32_t seed) {
+    FILE *f = fopen(path, "wb");
+    uint32_t t,
+             time_us = 0;
+    int32_t aim,
+            reading;
+    uint16_t start = (RECORD_VERSION << 8) | 1,
+             pot,
+             joystick;
+    uint8_t toggles;
+
+    if (f == NULL) {
+        return 1;
+    }
+    srand(seed);
+
+    put(f, time_us, RECORD_START, start);
+    game_init(&game, 1, false);
+    input.paddle_top_y = game.paddle_top.b_left.y;
+    input.paddle_bottom_y = game.paddle_bottom.b_left.y;
+    input.speed_toggles = 0;
+
+    for (t = 0; t < ticks; ++t) {
+        time_us += TICK_US;
+
+        // reading falls as paddle rises, see POT_TABLE in input.c
+        aim = game.balls.y[0] - (PADDLE_WIDTH / 2) + (rand() % (2 * AIM_ERROR + 1)) - AIM_ERROR;
+        reading = POT_MAX - (((aim - PADDLE_Y_MIN) * (POT_MAX - POT_MIN)) / (PADDLE_Y_MAX - PADDLE_Y_MIN));
+        reading += (rand() % (2 * POT_NOISE + 1)) - POT_NOISE;
+        pot = (uint16_t) ((reading < 0) ? 0 : ((reading > 4095) ? 4095 : reading));
+        put(f, time_us, RECORD_POT, pot);
+        input_pot(&input, pot);
+
+        if ((t % JOYSTICK_PERIOD) == 0) {
+            aim = game.balls.y[0] - (PADDLE_WIDTH / 2) - input.paddle_bottom_y;
+            joystick = (aim > AIM_ERROR / 2) ? 32 : ((aim < -(AIM_ERROR / 2)) ? 8 : 0);
+            if (joystick != 0) {
+                put(f, time_us, RECORD_JOYSTICK, joystick);
+                input_joystick(&input, joystick);
+            }
+        }
+
+        toggles = 0;
+        if ((rand() % PRESS_CHANCE) == 0) {
+            put(f, time_us, RECORD_BUTTON, 0);
+            toggles = 1;
+        }
+        put(f, time_us, RECORD_TICK, toggles);
+        input.speed_toggles = toggles;
+        if (game_step(&game, &input) & GAME_EVENT_GAME_OVER) {
+            put(f, time_us, RECORD_NEW_MATCH, 0);
+            game_new_match(&game);
+        }
+        input.speed_toggles = 0;
+    }
+    fclose(f);
+
+    printf("wrote %u ticks to %s, final checksum %04x\n", ticks, path, link_checksum(&game));
+    return 0;
+}
+
+/*******************************************************************************
+*   Function Name:      show_state
+*   Author(s):          George Cowan
+*   Definition:         prints final game state and checksum
+*******************************************************************************/
+static void show_state(void) {
+    uint8_t i;
+
+    printf("balls %u%s, speed %u, score top %u bottom %u%s\n", game.balls.count,
+           game.brick_mode ? " with bricks" : "", game.speed_index,
+           game.top_score, game.bottom_score, game.over ? ", game over" : "");
+    printf("paddles top %u bottom %u\n", game.paddle_top.b_left.y, game.paddle_bottom.b_left.y);
+    for (i = 0; i < game.balls.count && i < BALLS_SHOWN; ++i) {
+        printf("ball %u at %u,%u moving %d,%d\n", i, game.balls.x[i], game.balls.y[i],
+               game.balls.vx[i], game.balls.vy[i]);
+    }
+    if (game.brick_mode) {
+        printf("bricks left %u\n", game.bricks.count);
+    }
+    printf("checksum %04x\n", link_checksum(&game));
+}
+
+/*******************************************************************************
+*   Function Name:      replay
+*   Author(s):          George Cowan
+*   Definition:         replays a capture file several times, prints what it
+                        held, how fast it ran and where game ended, passes
+                        must all end in same state
+*   Parameters:         path
+*   Returns:            0 if file was read and every pass agreed
+*******************************************************************************/
+static int replay(const char *path) {
+    Sample *log;
+    uint64_t best = 0,
+             start;
+    uint32_t count,
+             sources[SOURCES],
+             other = 0,
+             gaps = 0,
+             span_us = 0,
+             steps = 0,
+             i;
+    uint16_t sum = 0;
+    uint8_t pass;
+    bool agree = true;
+
+    log = load(path, &count);
+    if (log == NULL) {
+        printf("cannot read %s\n", path);
+        return 1;
+    }
+
+    memset(sources, 0, sizeof(sources));
+    for (i = 0; i < count; ++i) {
+        if (log[i].source < SOURCES) {
+            ++sources[log[i].source];
+        }
+        else {
+            ++other;
+        }
+        if (i > 0) {
+            // seq and time wrap, unsigned differences stay right
+            gaps += (uint8_t) (log[i].seq - log[i - 1].seq - 1);
+            span_us += log[i].time_us - log[i - 1].time_us;
+        }
+    }
+    printf("%u samples over %.1f s, %u missing by sequence\n", count, span_us / 1e6, gaps);
+    for (i = 0; i < SOURCES; ++i) {
+        printf("  %-10s %u\n", SOURCE_NAMES[i], sources[i]);
+    }
+    if (other > 0) {
+        printf("  %-10s %u\n", "unknown", other);
+    }
+    if (count == 0 || log[0].source != RECORD_START) {
+        printf("no start marker, replaying into a one ball game\n");
+    }
+
+    for (pass = 0; pass < PASSES; ++pass) {
+        // a log cut from middle of a recording has no start marker
+        game_init(&game, 1, false);
+        input.paddle_top_y = game.paddle_top.b_left.y;
+        input.paddle_bottom_y = game.paddle_bottom.b_left.y;
+        input.speed_toggles = 0;
+
+        start = now_ns();
+        steps = replay_run(&game, &input, log, count);
+        start = now_ns() - start;
+        if (pass == 0 || start < best) {
+            best = start;
+        }
+        if (pass > 0 && link_checksum(&game) != sum) {
+            agree = false;
+        }
+        sum = link_checksum(&game);
+    }
+
+    printf("%u steps in %.2f ms, %.0f steps/s, %.0fx real time\n", steps, best / 1e6,
+           steps / (best / 1e9), (best > 0) ? (span_us * 1e3) / best : 0.0);
+    show_state();
+    if (!agree) {
+        printf("passes ended in different states FAILED\n");
+    }
+
+    free(log);
+    return agree ? 0 : 1;
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         replays a capture file, or writes a scripted one
+*   Parameters:         FILE, or -w FILE [ticks] [seed]
+*   Returns:            0 on success
+*******************************************************************************/
+int main(int argc, char **argv) {
+    if (argc >= 3 && strcmp(argv[1], "-w") == 0) {
+        return write_match(argv[2], (argc > 3) ? (uint32_t) atoi(argv[3]) : DEFAULT_TICKS,
+                           (argc > 4) ? (uint32_t) atoi(argv[4]) : 1);
+    }
+    if (argc == 2) {
+        return replay(argv[1]);
+    }
+
+    printf("usage: replay_host FILE\n"
+           "       replay_host -w FILE [ticks] [seed]\n");
+    return 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,126 @@
+/*----------------------------------------------------------------------------
+* Filename:         sampler.c
+* Description:      Fixed rate joystick and push button sampler for pong on
+*                   Keil MCB1700 board, driven by repetitive interrupt timer,
+*                   posts only changed input to an RTX mailbox
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <lpc17xx.h>
+#include <rtl.h>
+#include "joystick.h"
+#include "sampler.h"
+
+/*----------------------------------------------------------------------------
+ *      Sampler Constants
+ *---------------------------------------------------------------------------*/
+
+// RICTRL bits
+#define RIT_INT                 (1u << 0)
+#define RIT_ENCLR               (1u << 1)
+#define RIT_EN                  (1u << 3)
+// PCONP bit
+#define PCONP_RIT               (1u << 16)
+
+extern uint32_t SystemCoreClock;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+uint32_t sampler_full = 0;
+uint32_t sampler_ticks = 0;
+
+static OS_ID            sampler_mailbox;
+// state last posted, reading waiting to settle and samples it has held
+static uint32_t         sampler_posted;
+static uint32_t         sampler_pending;
+static uint8_t          sampler_stable;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      sampler_start
+*   Author(s):          George Cowan
+*   Definition:         sets up joystick and push button pins and starts
+                        repetitive interrupt timer at given rate, joystick
+                        has no pin interrupt so it is sampled, push button
+                        is sampled with it so both are debounced alike
+                        current state is posted once so receiver starts in
+                        step
+*   Parameters:         mailbox to post state to (initialized by caller),
+                        samples per second
+*******************************************************************************/
+void sampler_start(OS_ID mailbox, uint16_t rate_hz) {
+    joystick_setup();
+    pushbutton_setup();
+
+    sampler_mailbox = mailbox;
+    sampler_full = 0;
+    sampler_ticks = 0;
+    sampler_posted = SAMPLER_VALID | (joystick_read() & SAMPLER_JOYSTICK_MASK) |
+                     (pushbutton_read() ? 0 : SAMPLER_BUTTON_DOWN);
+    sampler_pending = sampler_posted;
+    sampler_stable = SAMPLER_DEBOUNCE;
+    os_mbx_send(sampler_mailbox, (void *) sampler_posted, 0xFFFF);
+
+    // RIT clock is core clock / 4 at reset, counter clears on match
+    LPC_SC->PCONP |= PCONP_RIT;
+    LPC_RIT->RICOUNTER = 0;
+    LPC_RIT->RIMASK = 0;
+    LPC_RIT->RICOMPVAL = ((SystemCoreClock / 4) / rate_hz) - 1;
+    LPC_RIT->RICTRL = RIT_INT | RIT_ENCLR | RIT_EN;
+    NVIC_EnableIRQ(RIT_IRQn);
+}
+
+/*******************************************************************************
+*   Function Name:      sampler_stop
+*   Author(s):          George Cowan
+*   Definition:         stops sampling, nothing is posted until restarted
+*******************************************************************************/
+void sampler_stop(void) {
+    NVIC_DisableIRQ(RIT_IRQn);
+    LPC_RIT->RICTRL &= ~RIT_EN;
+}
+
+/*******************************************************************************
+*   Function Name:      RIT_IRQHandler
+*   Author(s):          George Cowan
+*   Definition:         reads joystick and push button once per sample, a
+                        reading different from last one posted is posted
+                        after it holds for SAMPLER_DEBOUNCE samples, so an
+                        untouched controller costs two pin reads and no
+                        task wake ups
+*******************************************************************************/
+void RIT_IRQHandler(void) {
+    uint32_t state = SAMPLER_VALID | (joystick_read() & SAMPLER_JOYSTICK_MASK) |
+                     (pushbutton_read() ? 0 : SAMPLER_BUTTON_DOWN);
+
+    LPC_RIT->RICTRL |= RIT_INT;
+    ++sampler_ticks;
+
+    if (state != sampler_pending) {
+        sampler_pending = state;
+        sampler_stable = 0;
+        return;
+    }
+    if (sampler_stable >= SAMPLER_DEBOUNCE || ++sampler_stable < SAMPLER_DEBOUNCE ||
+        state == sampler_posted) {
+        return;
+    }
+
+    if (isr_mbx_check(sampler_mailbox) == 0) {
+        // retried next sample, stable count is held short of done
+        --sampler_stable;
+        ++sampler_full;
+        return;
+    }
+    isr_mbx_send(sampler_mailbox, (void *) state);
+    sampler_posted = state;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
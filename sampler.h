@@ -0,0 +1,36 @@
+/*----------------------------------------------------------------------------
+* Filename:         sampler.h
+* Description:      Fixed rate joystick and push button sampler for pong on
+*                   Keil MCB1700 board, driven by repetitive interrupt timer,
+*                   posts only changed input to an RTX mailbox
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _SAMPLER_H
+#define _SAMPLER_H
+
+// samples a new reading must hold for before it is posted, filters
+// contact bounce
+#define SAMPLER_DEBOUNCE        3
+
+// message layout, message is the whole input state so a dropped message
+// only loses a change, never the current state
+#define SAMPLER_JOYSTICK_MASK   0x7Fu   // joystick_read bits
+#define SAMPLER_BUTTON_DOWN     (1u << 8)
+// always set so no message is a NULL pointer
+#define SAMPLER_VALID           (1u << 31)
+
+// samples a settled change waited because mailbox was full, change is
+// posted once there is room
+extern uint32_t sampler_full;
+// interrupts taken since sampler_start, for measuring input cost
+extern uint32_t sampler_ticks;
+
+void        sampler_start   (OS_ID mailbox, uint16_t rate_hz);
+void        sampler_stop    (void);
+
+#endif /* _SAMPLER_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
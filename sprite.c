@@ -0,0 +1,150 @@
+/*----------------------------------------------------------------------------
+* Filename:         sprite.c
+* Description:      Windowed burst writes to LCD for sprites used in pong on
+*                   Keil MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "GLCD.h"
+#include "sprite.h"
+
+/*----------------------------------------------------------------------------
+ *      Sprite Constants
+ *---------------------------------------------------------------------------*/
+
+// one full LCD row, fill buffer holds two RGB565 pixels per word and is
+// shared with mask expansion
+#define FILL_BUFFER_PIXELS      320
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+uint32_t sprite_windows_opened = 0;
+uint32_t sprite_pixels_written = 0;
+
+static uint32_t         fill_buffer[FILL_BUFFER_PIXELS / 2];
+static unsigned short   fill_buffer_color;
+static bool             fill_buffer_valid = false;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      sprite_blit
+*   Author(s):          Alexander Rathke
+*   Definition:         opens LCD GRAM window over the sprite bounding box once
+                        and streams all pixels in a single burst, instead of
+                        setting the cursor for every pixel
+                        window is restored to full screen afterwards so
+                        GLCD_PutPixel callers are unaffected
+*   Parameters:         bottom left x and y of box, box width and height,
+                        row-major pixel colors (w * h entries)
+*******************************************************************************/
+void sprite_blit(uint16_t x, uint16_t y, uint16_t w, uint16_t h, unsigned short *pixels) {
+    if (w == 0 || h == 0) {
+        return;
+    }
+
+    GLCD_Bitmap(x, y, w, h, (unsigned char *) pixels);
+    GLCD_WindowMax();
+
+    ++sprite_windows_opened;
+    sprite_pixels_written += (uint32_t) w * h;
+}
+
+/*******************************************************************************
+*   Function Name:      sprite_blit_mask
+*   Author(s):          Alexander Rathke
+*   Definition:         draws 1-bit bitmap, color is applied here so bitmap
+                        can live in flash, expands as many rows per windowed
+                        burst as fit in the fill buffer
+*   Parameters:         bottom left x and y of box, box width (at most 16)
+                        and height, one row of bits per line (bit n is column
+                        n), color of set bits, color of clear bits
+*******************************************************************************/
+void sprite_blit_mask(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *rows,
+                      unsigned short color, unsigned short back_color) {
+    unsigned short *pixels = (unsigned short *) fill_buffer;
+    uint16_t rows_per_burst,
+             row,
+             col,
+             n;
+
+    if (w == 0 || h == 0) {
+        return;
+    }
+
+    rows_per_burst = FILL_BUFFER_PIXELS / w;
+
+    // buffer no longer holds a solid color
+    fill_buffer_valid = false;
+
+    while (h > 0) {
+        n = (h < rows_per_burst) ? h : rows_per_burst;
+        for (row = 0; row < n; ++row) {
+            for (col = 0; col < w; ++col) {
+                pixels[(row * w) + col] = (rows[row] & (1u << col)) ? color : back_color;
+            }
+        }
+        sprite_blit(x, y, w, n, pixels);
+        rows += n;
+        y += n;
+        h -= n;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      sprite_fill
+*   Author(s):          Alexander Rathke
+*   Definition:         fills box with one color using windowed bursts, as
+                        many full rows per window as fit in the fill buffer
+                        buffer is packed two pixels per 32-bit store and only
+                        refilled when the color changes
+*   Parameters:         bottom left x and y of box, box width and height, color
+*******************************************************************************/
+void sprite_fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, unsigned short color) {
+    uint32_t i,
+             packed = ((uint32_t) color << 16) | color;
+    uint16_t rows_per_burst,
+             rows;
+
+    if (w == 0 || h == 0) {
+        return;
+    }
+
+    if (!fill_buffer_valid || fill_buffer_color != color) {
+        for (i = 0; i < (FILL_BUFFER_PIXELS / 2); ++i) {
+            fill_buffer[i] = packed;
+        }
+        fill_buffer_color = color;
+        fill_buffer_valid = true;
+    }
+
+    rows_per_burst = (w >= FILL_BUFFER_PIXELS) ? 1 : (FILL_BUFFER_PIXELS / w);
+
+    while (h > 0) {
+        rows = (h < rows_per_burst) ? h : rows_per_burst;
+        sprite_blit(x, y, w, rows, (unsigned short *) fill_buffer);
+        y += rows;
+        h -= rows;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      sprite_reset_stats
+*   Author(s):          Alexander Rathke
+*   Definition:         clears LCD window and pixel counters
+*******************************************************************************/
+void sprite_reset_stats(void) {
+    sprite_windows_opened = 0;
+    sprite_pixels_written = 0;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,31 @@
+/*----------------------------------------------------------------------------
+* Filename:         sprite.h
+* Description:      Windowed burst writes to LCD for sprites used in pong on
+*                   Keil MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _SPRITE_H
+#define _SPRITE_H
+
+typedef struct {
+    // run of lit pixels in one row of a sprite, start is column of first
+    uint8_t start;
+    uint8_t length;
+} Span;
+
+// LCD bus usage since last sprite_reset_stats, for measuring draw cost
+extern uint32_t sprite_windows_opened;
+extern uint32_t sprite_pixels_written;
+
+void    sprite_blit         (uint16_t x, uint16_t y, uint16_t w, uint16_t h, unsigned short *pixels);
+void    sprite_blit_mask    (uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint16_t *rows,
+                             unsigned short color, unsigned short back_color);
+void    sprite_fill         (uint16_t x, uint16_t y, uint16_t w, uint16_t h, unsigned short color);
+void    sprite_reset_stats  (void);
+
+#endif /* _SPRITE_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,204 @@
+/*----------------------------------------------------------------------------
+* Filename:         sprite_host.c
+* Description:      Linux check of LCD bus cost of drawing a ball, per pixel
+*                   writes as ball was first drawn against one windowed burst
+*                   of its mask and against row spans, counted by GLCD
+*                   stand-in, and checks each draws same pixels, not part of
+*                   board image
+*                   build: gcc -Ihost -o sprite_host sprite_host.c sprite.c
+*                          ball.c point.c utils.c prof.c host/glcd_host.c
+*                   run:   sprite_host
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "GLCD.h"
+#include "point.h"
+#include "sprite.h"
+#include "ball.h"
+
+/*----------------------------------------------------------------------------
+ *      Check Constants
+ *---------------------------------------------------------------------------*/
+
+#define RADIUS                  6
+#define DIM                     ((2 * RADIUS) + 1)
+// ball centers drawn, spread over screen so clipping is never reached
+#define DRAWS                   64
+
+/*----------------------------------------------------------------------------
+ *      Check Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    const char *name;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t pixels;
+} Cost;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+static unsigned short expected[HEIGHT][WIDTH];
+static uint32_t errors = 0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      draw_per_pixel
+*   Author(s):          George Cowan
+*   Definition:         draws ball as it was drawn before windowed bursts, a
+                        color and a cursor set for every pixel of bounding box
+*   Parameters:         ball (needs bitmap)
+*******************************************************************************/
+static void draw_per_pixel(Ball *b) {
+    uint32_t i,
+             lower_left_x = b->center.x - b->radius,
+             lower_left_y = b->center.y - b->radius;
+
+    for (i = 0; i < (DIM * DIM); ++i) {
+        GLCD_SetTextColor((b->b_map[i / DIM] & (1u << (i % DIM))) ? b->color : Black);
+        GLCD_PutPixel(lower_left_x + (i % DIM), lower_left_y + (i / DIM));
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      draw_blit_mask
+*   Author(s):          George Cowan
+*   Definition:         draws ball bounding box in one windowed burst
+*   Parameters:         ball (needs bitmap)
+*******************************************************************************/
+static void draw_blit_mask(Ball *b) {
+    sprite_blit_mask(b->center.x - b->radius, b->center.y - b->radius,
+                     DIM, DIM, b->b_map, b->color, Black);
+}
+
+/*******************************************************************************
+*   Function Name:      draw_spans
+*   Author(s):          George Cowan
+*   Definition:         draws only lit run of each ball row, one short
+                        windowed burst per row, as frame compositor sends
+                        ball rows
+*   Parameters:         ball (needs spans)
+*******************************************************************************/
+static void draw_spans(Ball *b) {
+    uint16_t row,
+             x0 = b->center.x - b->radius,
+             y0 = b->center.y - b->radius;
+
+    for (row = 0; row < DIM; ++row) {
+        sprite_fill(x0 + b->spans[row].start, y0 + row, b->spans[row].length, 1, b->color);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      measure
+*   Author(s):          George Cowan
+*   Definition:         draws ball at spread positions on a cleared screen
+                        and counts bus cost
+*   Parameters:         cost to fill (name set), draw function
+*******************************************************************************/
+static void measure(Cost *c, void (*draw)(Ball *)) {
+    Ball b = new_ball(new_point(0, 0), Yellow);
+    uint16_t i;
+
+    generate_bitmap(&b);
+    GLCD_Init();
+    glcd_reset_stats();
+
+    for (i = 0; i < DRAWS; ++i) {
+        move_ball(&b, new_point(20 + (i % 8) * 37, 20 + (i / 8) * 26));
+        draw(&b);
+    }
+
+    c->transactions = glcd_transactions;
+    c->bytes = glcd_bytes;
+    c->pixels = glcd_pixels;
+}
+
+/*******************************************************************************
+*   Function Name:      compare
+*   Author(s):          George Cowan
+*   Definition:         checks screen against per pixel drawing
+*   Parameters:         cost (for name), true to compare every pixel (whole
+                        bounding box drawn), false to compare lit pixels only
+*******************************************************************************/
+static void compare(const Cost *c, bool whole_box) {
+    uint16_t x, y;
+    bool wrong;
+
+    for (y = 0; y < HEIGHT; ++y) {
+        for (x = 0; x < WIDTH; ++x) {
+            if (whole_box) {
+                wrong = (glcd_screen[y][x] != expected[y][x]);
+            }
+            else {
+                wrong = ((glcd_screen[y][x] == Yellow) != (expected[y][x] == Yellow));
+            }
+            if (wrong) {
+                if (errors < 10) {
+                    printf("%s: pixel %u,%u is %04x, expected %04x\n",
+                           c->name, x, y, glcd_screen[y][x], expected[y][x]);
+                }
+                ++errors;
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         measures each way of drawing ball and prints cost per
+                        draw, per pixel drawing is reference for pixels
+*   Returns:            0 if every way drew same ball
+*******************************************************************************/
+int main(void) {
+    Cost costs[3] = {
+        { "per pixel",  0, 0, 0 },
+        { "blit mask",  0, 0, 0 },
+        { "row spans",  0, 0, 0 }
+    };
+    uint8_t i;
+
+    measure(&costs[0], draw_per_pixel);
+    memcpy(expected, glcd_screen, sizeof(expected));
+
+    measure(&costs[1], draw_blit_mask);
+    compare(&costs[1], true);
+    measure(&costs[2], draw_spans);
+    compare(&costs[2], false);
+
+    // empty boxes send nothing
+    glcd_reset_stats();
+    sprite_blit_mask(20, 20, 0, DIM, ball_mask(RADIUS), Yellow, Black);
+    sprite_blit_mask(20, 20, DIM, 0, ball_mask(RADIUS), Yellow, Black);
+    sprite_fill(20, 20, 0, DIM, Yellow);
+    if (glcd_transactions != 0) {
+        printf("empty box sent %u transactions\n", glcd_transactions);
+        ++errors;
+    }
+
+    printf("radius %u ball, %u draws\n", RADIUS, DRAWS);
+    printf("%-10s %14s %10s %10s\n", "", "transactions", "bytes", "pixels");
+    for (i = 0; i < 3; ++i) {
+        printf("%-10s %14.1f %10.1f %10.1f\n", costs[i].name,
+               (double) costs[i].transactions / DRAWS,
+               (double) costs[i].bytes / DRAWS,
+               (double) costs[i].pixels / DRAWS);
+    }
+    printf("pixel errors %u %s\n", errors, errors == 0 ? "ok" : "FAILED");
+
+    return errors == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,304 @@
+/*----------------------------------------------------------------------------
+* Filename:         sweep_host.c
+* Description:      Linux check of swept ball collision against a brute force
+*                   reference, for each ball speed makes random one step
+*                   moves through game field and counts hits collide_sweep
+*                   misses (ball tunnels through a paddle, border or goal
+*                   line), hits it reports that are not there, and hits a
+*                   check of end position alone would miss, then times
+*                   sweep and reference in steps per second, not part of
+*                   board image
+*                   build: gcc -O2 -o sweep_host sweep_host.c game.c
+*                          collide.c bricks.c fixed.c prof.c -lm
+*                   run:   sweep_host [moves per speed] [seed]
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+
+/*----------------------------------------------------------------------------
+ *      Check Constants
+ *---------------------------------------------------------------------------*/
+
+#define DEFAULT_MOVES           50000
+// reference samples this many points per pixel of move
+#define SAMPLES_PER_PIXEL       64
+#define PI                      3.14159265358979
+
+/*----------------------------------------------------------------------------
+ *      Check Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    Point center;
+    int16_t dx, dy;
+    uint16_t paddle_y;
+} Move;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+// speeds swept, 7 and 15 are game speeds, 31 is fastest ball to ball
+// bounces allow
+static const uint8_t    SPEEDS[] = {1, 3, 7, 11, 15, 20, 25, 31};
+
+static Game             game;
+static uint16_t         radius;
+static Move            *moves;
+// keeps optimizer from dropping timed sweeps
+static volatile int32_t sink;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      now_ns
+*   Author(s):          George Cowan
+*   Definition:         reads monotonic clock
+*   Returns:            nanoseconds
+*******************************************************************************/
+static uint64_t now_ns(void) {
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((uint64_t) t.tv_sec * 1000000000u) + t.tv_nsec;
+}
+
+/*******************************************************************************
+*   Function Name:      set_paddles
+*   Author(s):          George Cowan
+*   Definition:         moves both paddles to bottom left y
+*   Parameters:         y
+*******************************************************************************/
+static void set_paddles(uint16_t y) {
+    game.paddle_bottom.b_left.y = y;
+    game.paddle_bottom.t_right.y = y + PADDLE_WIDTH;
+    game.paddle_top.b_left.y = y;
+    game.paddle_top.t_right.y = y + PADDLE_WIDTH;
+}
+
+/*******************************************************************************
+*   Function Name:      touching
+*   Author(s):          George Cowan
+*   Definition:         checks if ball center at a point touches collider,
+                        solid colliders within ball reach of any pixel,
+                        sensors with center inside
+*   Parameters:         center x and y, collider
+*   Returns:            true if touching
+*******************************************************************************/
+static bool touching(double x, double y, const Collider *c) {
+    double reach = c->sensor ? 0 : radius + 1,
+           ox = 0,
+           oy = 0;
+
+    if (x < c->rect->b_left.x) {
+        ox = c->rect->b_left.x - x;
+    }
+    else if (x > c->rect->t_right.x) {
+        ox = x - c->rect->t_right.x;
+    }
+    if (y < c->rect->b_left.y) {
+        oy = c->rect->b_left.y - y;
+    }
+    else if (y > c->rect->t_right.y) {
+        oy = y - c->rect->t_right.y;
+    }
+    return (ox * ox) + (oy * oy) <= reach * reach;
+}
+
+/*******************************************************************************
+*   Function Name:      touching_any
+*   Author(s):          George Cowan
+*   Definition:         first collider ball center at a point touches
+*   Parameters:         center x and y
+*   Returns:            collider index, COLLIDE_NONE if clear
+*******************************************************************************/
+static int8_t touching_any(double x, double y) {
+    int8_t i;
+
+    for (i = 0; i < COLLIDER_COUNT; ++i) {
+        if (touching(x, y, &game.colliders[i])) {
+            return i;
+        }
+    }
+    return COLLIDE_NONE;
+}
+
+/*******************************************************************************
+*   Function Name:      reference
+*   Author(s):          George Cowan
+*   Definition:         brute force first contact, samples move finely and
+                        reports first collider touched
+*   Parameters:         move
+*   Returns:            collider index, COLLIDE_NONE if move is clear
+*******************************************************************************/
+static int8_t reference(const Move *m) {
+    uint32_t k,
+             samples = SAMPLES_PER_PIXEL * (abs(m->dx) + abs(m->dy));
+    int8_t hit;
+
+    for (k = 1; k <= samples; ++k) {
+        hit = touching_any(m->center.x + ((double) m->dx * k) / samples,
+                           m->center.y + ((double) m->dy * k) / samples);
+        if (hit != COLLIDE_NONE) {
+            return hit;
+        }
+    }
+    return COLLIDE_NONE;
+}
+
+/*******************************************************************************
+*   Function Name:      make_moves
+*   Author(s):          George Cowan
+*   Definition:         random moves of one speed at random angles, starting
+                        anywhere in field clear of every collider
+*   Parameters:         speed, number of moves
+*******************************************************************************/
+static void make_moves(uint8_t speed, uint32_t count) {
+    Move *m;
+    double angle;
+    uint32_t i;
+
+    for (i = 0; i < count; ++i) {
+        m = &moves[i];
+        m->paddle_y = PADDLE_Y_MIN + (rand() % (PADDLE_Y_MAX - PADDLE_Y_MIN + 1));
+        set_paddles(m->paddle_y);
+        do {
+            m->center.x = rand() % 320;
+            m->center.y = rand() % 240;
+        } while (touching_any(m->center.x, m->center.y) != COLLIDE_NONE);
+        do {
+            angle = (2 * PI * rand()) / RAND_MAX;
+            m->dx = (int16_t) lround(speed * cos(angle));
+            m->dy = (int16_t) lround(speed * sin(angle));
+        } while (m->dx == 0 && m->dy == 0);
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      check
+*   Author(s):          George Cowan
+*   Definition:         runs each move through sweep, end position check and
+                        reference and counts disagreements, extra hits are
+                        sweep touching a rectangle corner at end of move,
+                        where it rounds root up and reference does not
+*   Parameters:         number of moves, reference hits, sweep misses, sweep
+                        hits not in reference, end check misses (modified)
+*******************************************************************************/
+static void check(uint32_t count, uint32_t *hits, uint32_t *missed, uint32_t *extra,
+                  uint32_t *end_missed) {
+    Contact c;
+    int8_t expected;
+    uint32_t i;
+
+    *hits = *missed = *extra = *end_missed = 0;
+    for (i = 0; i < count; ++i) {
+        set_paddles(moves[i].paddle_y);
+        expected = reference(&moves[i]);
+        c = collide_sweep(moves[i].center, radius, moves[i].dx, moves[i].dy,
+                          game.colliders, COLLIDER_COUNT);
+
+        if (expected == COLLIDE_NONE) {
+            *extra += (c.index != COLLIDE_NONE);
+            continue;
+        }
+        ++*hits;
+        if (c.index == COLLIDE_NONE) {
+            if (*missed < 5) {
+                printf("missed %d from %u,%u by %d,%d paddles at %u\n", expected,
+                       moves[i].center.x, moves[i].center.y, moves[i].dx, moves[i].dy,
+                       moves[i].paddle_y);
+            }
+            ++*missed;
+        }
+        if (touching_any(moves[i].center.x + moves[i].dx, moves[i].center.y + moves[i].dy) == COLLIDE_NONE) {
+            ++*end_missed;
+        }
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      steps_per_sec
+*   Author(s):          George Cowan
+*   Definition:         times sweep or reference over all moves
+*   Parameters:         number of moves, true to time reference
+*   Returns:            moves per second
+*******************************************************************************/
+static double steps_per_sec(uint32_t count, bool use_reference) {
+    Contact c;
+    uint64_t start = now_ns();
+    uint32_t i;
+
+    for (i = 0; i < count; ++i) {
+        set_paddles(moves[i].paddle_y);
+        if (use_reference) {
+            sink += reference(&moves[i]);
+        }
+        else {
+            c = collide_sweep(moves[i].center, radius, moves[i].dx, moves[i].dy,
+                              game.colliders, COLLIDER_COUNT);
+            sink += c.index;
+        }
+    }
+    return count / ((now_ns() - start) / 1e9);
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         checks and times every speed
+*   Parameters:         moves per speed, random seed
+*   Returns:            0 if sweep never missed a hit
+*******************************************************************************/
+int main(int argc, char **argv) {
+    uint32_t count = (argc > 1) ? (uint32_t) atoi(argv[1]) : DEFAULT_MOVES,
+             hits,
+             missed,
+             extra,
+             end_missed,
+             total_missed = 0;
+    uint8_t s;
+
+    srand((argc > 2) ? (unsigned) atoi(argv[2]) : 1);
+    moves = malloc(count * sizeof(Move));
+    if (moves == NULL || count == 0) {
+        return 1;
+    }
+    game_init(&game, 1, false);
+    radius = game.balls.radius[0];
+
+    printf("%u moves per speed\n", count);
+    printf("%-6s %8s %8s %8s %12s %14s %14s\n", "speed", "hits", "missed", "extra",
+           "end missed", "sweep steps/s", "brute steps/s");
+    for (s = 0; s < sizeof(SPEEDS); ++s) {
+        make_moves(SPEEDS[s], count);
+        check(count, &hits, &missed, &extra, &end_missed);
+        printf("%-6u %8u %8u %8u %12u %14.0f %14.0f\n", SPEEDS[s], hits, missed, extra,
+               end_missed, steps_per_sec(count, false), steps_per_sec(count, true));
+        total_missed += missed;
+    }
+    printf("missed hits %u %s\n", total_missed, total_missed == 0 ? "ok" : "FAILED");
+
+    free(moves);
+    return total_missed == 0 ? 0 : 1;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
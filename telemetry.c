@@ -0,0 +1,91 @@
+/*----------------------------------------------------------------------------
+* Filename:         telemetry.c
+* Description:      Fixed layout binary snapshot of pong game state for Keil
+*                   MCB1700 board, packing only, builds on host for the
+*                   decoder, sending is in telemetry_dma.c
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "telemetry.h"
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+// fails to compile if compiler padded record away from wire layout
+typedef char telemetry_size_check[(sizeof(Telemetry) == TELEMETRY_SIZE) ? 1 : -1];
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      telemetry_checksum
+*   Author(s):          George Cowan
+*   Definition:         fletcher-16 over bytes, catches reordered bytes that
+                        a plain sum would miss
+*   Parameters:         bytes, number of bytes
+*   Returns:            second sum in high byte, first sum in low byte
+*******************************************************************************/
+uint16_t telemetry_checksum(const uint8_t *bytes, uint32_t length) {
+    uint16_t sum1 = 0,
+             sum2 = 0;
+    uint32_t i;
+
+    for (i = 0; i < length; ++i) {
+        sum1 = (sum1 + bytes[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+
+    return (sum2 << 8) | sum1;
+}
+
+/*******************************************************************************
+*   Function Name:      telemetry_pack
+*   Author(s):          George Cowan
+*   Definition:         packs game state into one record and seals it with
+                        checksum
+*   Parameters:         record (modified), game, frame timestamp, sequence
+                        number
+*******************************************************************************/
+void telemetry_pack(Telemetry *t, const Game *g, uint32_t time_us, uint8_t seq) {
+    t->magic = TELEMETRY_MAGIC;
+    t->version = TELEMETRY_VERSION;
+    t->seq = seq;
+    t->time_us = time_us;
+
+    t->ball_x = g->balls.x[0];
+    t->ball_y = g->balls.y[0];
+    t->ball_vx = g->balls.vx[0];
+    t->ball_vy = g->balls.vy[0];
+    t->ball_count = g->balls.count;
+
+    t->top_score = g->top_score;
+    t->bottom_score = g->bottom_score;
+    t->speed_index = g->speed_index;
+
+    t->paddle_top[0] = g->paddle_top.b_left.x;
+    t->paddle_top[1] = g->paddle_top.b_left.y;
+    t->paddle_top[2] = g->paddle_top.t_right.x;
+    t->paddle_top[3] = g->paddle_top.t_right.y;
+    t->paddle_bottom[0] = g->paddle_bottom.b_left.x;
+    t->paddle_bottom[1] = g->paddle_bottom.b_left.y;
+    t->paddle_bottom[2] = g->paddle_bottom.t_right.x;
+    t->paddle_bottom[3] = g->paddle_bottom.t_right.y;
+
+    t->checksum = telemetry_checksum((const uint8_t *) t, TELEMETRY_SIZE - sizeof(t->checksum));
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,59 @@
+/*----------------------------------------------------------------------------
+* Filename:         telemetry.h
+* Description:      Fixed layout binary snapshot of pong game state, sent
+*                   once per game frame over UART0 by GPDMA on Keil MCB1700
+*                   board, layout is shared with host decoder
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _TELEMETRY_H
+#define _TELEMETRY_H
+
+// first two bytes of every record, "TE" on the wire
+#define TELEMETRY_MAGIC         0x4554
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_SIZE          36
+
+typedef struct {
+    /*
+    one game frame, 36 bytes little endian on the
+    wire, every field is naturally aligned so there
+    is no padding, seq counts up by one per record
+    so gaps show frames skipped, checksum is
+    fletcher-16 over every byte before it
+    */
+    uint16_t magic;
+    uint8_t version;
+    uint8_t seq;
+    // microseconds since power on when frame was stepped
+    uint32_t time_us;
+    // first ball only, ball_count tells if there are more
+    uint16_t ball_x;
+    uint16_t ball_y;
+    int8_t ball_vx;
+    int8_t ball_vy;
+    uint8_t top_score;
+    uint8_t bottom_score;
+    // bottom left x, y then top right x, y
+    uint16_t paddle_top[4];
+    uint16_t paddle_bottom[4];
+    uint8_t speed_index;
+    uint8_t ball_count;
+    uint16_t checksum;
+} Telemetry;
+
+// records sent, and frames skipped because last record was still sending,
+// board only like telemetry_start and telemetry_send in telemetry_dma.c
+extern uint32_t telemetry_sent;
+extern uint32_t telemetry_busy;
+
+void        telemetry_pack      (Telemetry *t, const Game *g, uint32_t time_us, uint8_t seq);
+uint16_t    telemetry_checksum  (const uint8_t *bytes, uint32_t length);
+void        telemetry_start     (void);
+bool        telemetry_send      (const Game *g, uint32_t time_us);
+
+#endif /* _TELEMETRY_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
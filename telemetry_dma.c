@@ -0,0 +1,115 @@
+/*----------------------------------------------------------------------------
+* Filename:         telemetry_dma.c
+* Description:      Sends telemetry records packed by telemetry.c over UART0
+*                   by GPDMA, once per game frame, on Keil MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <lpc17xx.h>
+#include <stdbool.h>
+#include "uart.h"
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "telemetry.h"
+
+/*----------------------------------------------------------------------------
+ *      Telemetry Constants
+ *---------------------------------------------------------------------------*/
+
+// lowest priority channel, telemetry gives way to any other transfer
+#define TELEMETRY_CHANNEL       7
+#define TELEMETRY_DMA           LPC_GPDMACH7
+// DMA request line of UART0 TX, DMAREQSEL bit 0 left clear
+#define DMA_PERIPHERAL_UART0_TX 8
+
+// PCONP bit powering GPDMA
+#define PCONP_PCGPDMA           (1u << 29)
+// DMACConfig, controller enabled, little endian
+#define DMAC_CONFIG_E           (1u << 0)
+// DMACCControl, byte wide source and destination, single beat bursts,
+// source address steps, transfer size is low 12 bits
+#define DMACC_CONTROL_SI        (1u << 26)
+// DMACCConfig, channel enabled, memory to peripheral
+#define DMACC_CONFIG_E          (1u << 0)
+#define DMACC_CONFIG_DEST(p)    ((uint32_t) (p) << 6)
+#define DMACC_CONFIG_M2P        (1u << 11)
+
+// FCR, FIFOs on with DMA requests, RX trigger kept at 8 bytes
+#define FCR_FIFO_DMA            0x89
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+uint32_t telemetry_sent = 0;
+uint32_t telemetry_busy = 0;
+
+// read by DMA while channel is enabled, only packed while it is idle
+static Telemetry        telemetry_record;
+static uint8_t          telemetry_seq = 0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      telemetry_start
+*   Author(s):          George Cowan
+*   Definition:         powers GPDMA and hands UART0 transmitter to it, TX
+                        ring interrupt is turned off so only DMA writes THR
+                        and UARTSend must not be used on UART0 after this
+                        UARTInit must have set up UART0
+*******************************************************************************/
+void telemetry_start(void) {
+    LPC_SC->PCONP |= PCONP_PCGPDMA;
+    LPC_GPDMA->DMACConfig |= DMAC_CONFIG_E;
+
+    LPC_UART0->IER &= ~IER_THRE;
+    LPC_UART0->FCR = FCR_FIFO_DMA;
+
+    telemetry_sent = 0;
+    telemetry_busy = 0;
+}
+
+/*******************************************************************************
+*   Function Name:      telemetry_send
+*   Author(s):          George Cowan
+*   Definition:         packs game state and starts DMA sending it, returns
+                        at once, CPU does no work per byte
+                        frame is skipped if last record is still sending, so
+                        caller never waits on UART
+*   Parameters:         game, frame timestamp
+*   Returns:            true if record was started, false if skipped
+*******************************************************************************/
+bool telemetry_send(const Game *g, uint32_t time_us) {
+    if (LPC_GPDMA->DMACEnbldChns & (1u << TELEMETRY_CHANNEL)) {
+        ++telemetry_busy;
+        return false;
+    }
+
+    telemetry_pack(&telemetry_record, g, time_us, telemetry_seq++);
+
+    LPC_GPDMA->DMACIntTCClear = (1u << TELEMETRY_CHANNEL);
+    LPC_GPDMA->DMACIntErrClr = (1u << TELEMETRY_CHANNEL);
+
+    TELEMETRY_DMA->DMACCSrcAddr = (uint32_t) &telemetry_record;
+    TELEMETRY_DMA->DMACCDestAddr = (uint32_t) &LPC_UART0->THR;
+    TELEMETRY_DMA->DMACCLLI = 0;
+    TELEMETRY_DMA->DMACCControl = TELEMETRY_SIZE | DMACC_CONTROL_SI;
+    TELEMETRY_DMA->DMACCConfig = DMACC_CONFIG_E |
+                                 DMACC_CONFIG_DEST(DMA_PERIPHERAL_UART0_TX) |
+                                 DMACC_CONFIG_M2P;
+
+    ++telemetry_sent;
+    return true;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
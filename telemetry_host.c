@@ -0,0 +1,327 @@
+/*----------------------------------------------------------------------------
+* Filename:         telemetry_host.c
+* Description:      Linux decoder for pong telemetry stream, reads records
+*                   from a file, pipe or serial port/pty and prints frame
+*                   rate and latency, not part of board image
+*                   latency is arrival time less board time, less smallest
+*                   such difference among records of same report period,
+*                   so it is delay above best case seen that second, each
+*                   record is measured against baseline of whole period
+*                   once period is over rather than against smallest
+*                   difference seen so far, a capture file is read all at
+*                   once so its latency means nothing
+*                   build: gcc -o telemetry_host telemetry_host.c telemetry.c
+*                   run:   telemetry_host /dev/ttyUSB0  (or a capture file)
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include "fixed.h"
+#include "point.h"
+#include "rect.h"
+#include "sprite.h"
+#include "ball.h"
+#include "collide.h"
+#include "bricks.h"
+#include "game.h"
+#include "telemetry.h"
+
+/*----------------------------------------------------------------------------
+ *      Decoder Constants
+ *---------------------------------------------------------------------------*/
+
+#define READ_CHUNK              512
+// records held until their report period closes, a fuller period is
+// closed early
+#define PERIOD_RECORDS          4096
+// host nanoseconds between live statistics lines
+#define REPORT_NS               1000000000LL
+
+/*----------------------------------------------------------------------------
+ *      Decoder Types
+ *---------------------------------------------------------------------------*/
+
+typedef struct {
+    /*
+    statistics since last report, intervals are
+    board time between records, latency is delay
+    above best case of report period
+    */
+    uint32_t frames;
+    uint32_t intervals;
+    uint32_t skipped;
+    uint32_t bad;
+    uint32_t interval_min_us;
+    uint32_t interval_max_us;
+    uint64_t interval_total_us;
+    int64_t latency_max_ns;
+    int64_t latency_total_ns;
+} Stats;
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+// arrival time less board time of each record of current period
+static int64_t          offsets[PERIOD_RECORDS];
+static uint32_t         offset_count            =     0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      now_ns
+*   Author(s):          George Cowan
+*   Definition:         reads host monotonic clock
+*   Returns:            nanoseconds
+*******************************************************************************/
+static int64_t now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*******************************************************************************
+*   Function Name:      stats_clear
+*   Author(s):          George Cowan
+*   Definition:         starts a new reporting period
+*   Parameters:         statistics (modified)
+*******************************************************************************/
+static void stats_clear(Stats *s) {
+    memset(s, 0, sizeof(*s));
+    s->interval_min_us = 0xFFFFFFFF;
+}
+
+/*******************************************************************************
+*   Function Name:      stats_print
+*   Author(s):          George Cowan
+*   Definition:         prints one line of statistics
+*   Parameters:         statistics, label for line
+*******************************************************************************/
+static void stats_print(const Stats *s, const char *label) {
+    double mean_us = s->intervals ? (double) s->interval_total_us / s->intervals : 0.0;
+
+    printf("%s frames %u skipped %u bad %u", label, s->frames, s->skipped, s->bad);
+    if (s->intervals > 0) {
+        printf(" | %.1f fps interval %.2f/%.2f/%.2f ms", mean_us > 0.0 ? 1e6 / mean_us : 0.0,
+               s->interval_min_us / 1000.0, mean_us / 1000.0, s->interval_max_us / 1000.0);
+    }
+    if (s->frames > 0) {
+        printf(" | latency %.2f/%.2f ms", (double) s->latency_total_ns / s->frames / 1e6,
+               s->latency_max_ns / 1e6);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+/*******************************************************************************
+*   Function Name:      decode
+*   Author(s):          George Cowan
+*   Definition:         reads record byte by byte as little endian, as link
+                        decodes its packets, so host layout and byte order
+                        do not matter
+*   Parameters:         wire bytes (TELEMETRY_SIZE), record to fill
+*******************************************************************************/
+static void decode(const uint8_t *p, Telemetry *t) {
+    uint8_t i;
+
+    t->magic = p[0] | (p[1] << 8);
+    t->version = p[2];
+    t->seq = p[3];
+    t->time_us = p[4] | (p[5] << 8) | ((uint32_t) p[6] << 16) | ((uint32_t) p[7] << 24);
+    t->ball_x = p[8] | (p[9] << 8);
+    t->ball_y = p[10] | (p[11] << 8);
+    t->ball_vx = (int8_t) p[12];
+    t->ball_vy = (int8_t) p[13];
+    t->top_score = p[14];
+    t->bottom_score = p[15];
+    for (i = 0; i < 4; ++i) {
+        t->paddle_top[i] = p[16 + (2 * i)] | (p[17 + (2 * i)] << 8);
+        t->paddle_bottom[i] = p[24 + (2 * i)] | (p[25 + (2 * i)] << 8);
+    }
+    t->speed_index = p[32];
+    t->ball_count = p[33];
+    t->checksum = p[34] | (p[35] << 8);
+}
+
+/*******************************************************************************
+*   Function Name:      latency_close
+*   Author(s):          George Cowan
+*   Definition:         measures latency of every record held for period
+                        against smallest offset among them and adds it to
+                        both statistics
+*   Parameters:         period and total statistics (modified)
+*******************************************************************************/
+static void latency_close(Stats *period, Stats *total) {
+    int64_t base = INT64_MAX,
+            latency;
+    uint32_t i;
+
+    for (i = 0; i < offset_count; ++i) {
+        if (offsets[i] < base) {
+            base = offsets[i];
+        }
+    }
+    for (i = 0; i < offset_count; ++i) {
+        latency = offsets[i] - base;
+        period->latency_total_ns += latency;
+        total->latency_total_ns += latency;
+        if (latency > period->latency_max_ns) {
+            period->latency_max_ns = latency;
+        }
+        if (latency > total->latency_max_ns) {
+            total->latency_max_ns = latency;
+        }
+    }
+    offset_count = 0;
+}
+
+/*******************************************************************************
+*   Function Name:      open_input
+*   Author(s):          George Cowan
+*   Definition:         opens stream, serial ports and ptys are put in raw
+                        mode at board baud rate
+*   Parameters:         path, "-" for stdin
+*   Returns:            file descriptor, -1 on failure
+*******************************************************************************/
+static int open_input(const char *path) {
+    struct termios tio;
+    int fd = (strcmp(path, "-") == 0) ? 0 : open(path, O_RDONLY | O_NOCTTY);
+
+    if (fd >= 0 && isatty(fd) && tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    return fd;
+}
+
+/*******************************************************************************
+*   Function Name:      main
+*   Author(s):          George Cowan
+*   Definition:         decodes records until end of stream, resyncs on magic
+                        after a bad record, prints live statistics once a
+                        second and totals at end
+                        board time is widened to 64 bits by adding modular
+                        differences, so its wrap every 71 minutes does not
+                        upset intervals or latency
+*   Parameters:         path of stream, stdin if none
+*******************************************************************************/
+int main(int argc, char **argv) {
+    uint8_t buf[READ_CHUNK + TELEMETRY_SIZE];
+    Telemetry t;
+    Stats period,
+          total;
+    size_t have = 0,
+           pos;
+    ssize_t n;
+    int64_t arrival,
+            board_us = 0,
+            last_report;
+    uint32_t last_time = 0,
+             interval;
+    uint8_t gap;
+    uint8_t last_seq = 0;
+    bool first = true;
+    int fd = open_input(argc > 1 ? argv[1] : "-");
+
+    if (fd < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    stats_clear(&period);
+    stats_clear(&total);
+    last_report = now_ns();
+
+    while ((n = read(fd, buf + have, READ_CHUNK)) > 0) {
+        arrival = now_ns();
+        have += n;
+
+        pos = 0;
+        while (have - pos >= TELEMETRY_SIZE) {
+            decode(buf + pos, &t);
+            if (t.magic != TELEMETRY_MAGIC || t.version != TELEMETRY_VERSION ||
+                t.checksum != telemetry_checksum(buf + pos, TELEMETRY_SIZE - 2)) {
+                // not at a record, or record damaged, look one byte on
+                if (t.magic == TELEMETRY_MAGIC) {
+                    ++period.bad;
+                    ++total.bad;
+                }
+                ++pos;
+                continue;
+            }
+            pos += TELEMETRY_SIZE;
+
+            if (first) {
+                board_us = t.time_us;
+            }
+            else {
+                interval = t.time_us - last_time;
+                gap = (uint8_t) (t.seq - last_seq - 1);
+                board_us += interval;
+
+                ++period.intervals;
+                ++total.intervals;
+                period.skipped += gap;
+                total.skipped += gap;
+                period.interval_total_us += interval;
+                total.interval_total_us += interval;
+                if (interval < period.interval_min_us) {
+                    period.interval_min_us = interval;
+                }
+                if (interval > period.interval_max_us) {
+                    period.interval_max_us = interval;
+                }
+                if (interval < total.interval_min_us) {
+                    total.interval_min_us = interval;
+                }
+                if (interval > total.interval_max_us) {
+                    total.interval_max_us = interval;
+                }
+            }
+            first = false;
+            last_time = t.time_us;
+            last_seq = t.seq;
+
+            ++period.frames;
+            ++total.frames;
+            // records from one read arrived together, so latency is
+            // only as fine as read size allows
+            if (offset_count == PERIOD_RECORDS) {
+                latency_close(&period, &total);
+            }
+            offsets[offset_count++] = arrival - (board_us * 1000);
+        }
+
+        // keep partial record for next read
+        memmove(buf, buf + pos, have - pos);
+        have -= pos;
+
+        if (arrival - last_report >= REPORT_NS) {
+            latency_close(&period, &total);
+            stats_print(&period, "live ");
+            stats_clear(&period);
+            last_report = arrival;
+        }
+    }
+
+    latency_close(&period, &total);
+    stats_print(&total, "total");
+    return 0;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -0,0 +1,193 @@
+/*----------------------------------------------------------------------------
+* Filename:         tick.c
+* Description:      Fixed rate game tick from TIMER0 match interrupt with
+*                   budget accounting for pong on Keil MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#include <lpc17xx.h>
+#include <rtl.h>
+#include "timer.h"
+#include "tick.h"
+
+/*----------------------------------------------------------------------------
+ *      Tick Constants
+ *---------------------------------------------------------------------------*/
+
+// MCR bit, interrupt on MR0 match without resetting counter, TIMER0
+// keeps counting microseconds for timer_read
+#define MCR_MR0I                (1u << 0)
+// IR bit
+#define IR_MR0                  (1u << 0)
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+TickStats tick_stats;
+
+static OS_TID           tick_task;
+static uint32_t         tick_period_us;
+// written only by interrupt, single words so task reads need no lock
+static volatile uint32_t tick_raised        = 0;
+static volatile uint32_t tick_due_us        = 0;
+// ticks taken by task and time newest of them fell due
+static uint32_t         tick_taken          = 0;
+static uint32_t         tick_start_us       = 0;
+
+/*----------------------------------------------------------------------------
+ *      Function Definitions
+ *---------------------------------------------------------------------------*/
+
+/*******************************************************************************
+*   Function Name:      tick_start
+*   Author(s):          George Cowan
+*   Definition:         clears accounting and raises first tick one period
+                        from now, then every period after it, rate does not
+                        depend on how long task takes per tick
+                        timer_setup must have started TIMER0
+*   Parameters:         task to set TICK_EVENT on, microseconds per tick
+*******************************************************************************/
+void tick_start(OS_TID task, uint32_t period_us) {
+    tick_task = task;
+    tick_period_us = period_us;
+    tick_stats.raised = 0;
+    tick_stats.late = 0;
+    tick_stats.dropped = 0;
+    tick_stats.lock_missed = 0;
+    tick_stats.overruns = 0;
+    tick_stats.used_us = 0;
+    tick_stats.used_max_us = 0;
+    tick_raised = 0;
+    tick_taken = 0;
+
+    LPC_TIM0->MR0 = timer_read() + period_us;
+    LPC_TIM0->IR = IR_MR0;
+    LPC_TIM0->MCR |= MCR_MR0I;
+    NVIC_EnableIRQ(TIMER0_IRQn);
+}
+
+/*******************************************************************************
+*   Function Name:      tick_arm
+*   Author(s):          George Cowan
+*   Definition:         sets match one period on from when a tick was due,
+                        so late interrupts do not drift, if that time has
+                        already passed match is set one period from now
+                        instead, counter would otherwise run a whole wrap
+                        (over an hour) before matching again
+                        a higher priority interrupt may hold off the match
+                        write until counter is past it, so counter is read
+                        again after writing and match is moved one period
+                        from then if it was reached, a match that fired in
+                        between is cleared so the tick is not raised twice
+                        call with TIMER0 interrupt unable to run
+*   Parameters:         time tick was due
+*******************************************************************************/
+static void tick_arm(uint32_t due_us) {
+    if (timer_read() - due_us >= tick_period_us) {
+        LPC_TIM0->MR0 = timer_read() + tick_period_us;
+    }
+    else {
+        LPC_TIM0->MR0 = due_us + tick_period_us;
+    }
+
+    if ((int32_t) (timer_read() - LPC_TIM0->MR0) >= 0) {
+        LPC_TIM0->MR0 = timer_read() + tick_period_us;
+        LPC_TIM0->IR = IR_MR0;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      TIMER0_IRQHandler
+*   Author(s):          George Cowan
+*   Definition:         raises tick and moves match on to next tick
+*******************************************************************************/
+void TIMER0_IRQHandler(void) {
+    LPC_TIM0->IR = IR_MR0;
+
+    tick_due_us = LPC_TIM0->MR0;
+    tick_arm(tick_due_us);
+    ++tick_raised;
+    isr_evt_set(TICK_EVENT, tick_task);
+}
+
+/*******************************************************************************
+*   Function Name:      tick_wait
+*   Author(s):          George Cowan
+*   Definition:         blocks until at least one tick is due and takes all
+                        due ticks, caller steps once per tick taken so
+                        motion keeps its speed under load, ticks past
+                        TICK_MAX_CATCHUP are dropped and counted
+*   Returns:            number of ticks to step, 1 to TICK_MAX_CATCHUP
+*******************************************************************************/
+uint8_t tick_wait(void) {
+    uint32_t due;
+
+    do {
+        os_evt_wait_or(TICK_EVENT, 0xFFFF);
+        due = tick_raised - tick_taken;
+    } while (due == 0);
+
+    tick_taken += due;
+    tick_start_us = tick_due_us;
+    tick_stats.raised = tick_raised;
+    tick_stats.late += due - 1;
+
+    if (due > TICK_MAX_CATCHUP) {
+        tick_stats.dropped += due - TICK_MAX_CATCHUP;
+        due = TICK_MAX_CATCHUP;
+    }
+    return (uint8_t) due;
+}
+
+/*******************************************************************************
+*   Function Name:      tick_done
+*   Author(s):          George Cowan
+*   Definition:         closes budget of ticks taken by last tick_wait, time
+                        used is counted from when newest of them fell due
+*******************************************************************************/
+void tick_done(void) {
+    tick_stats.used_us = timer_read() - tick_start_us;
+    if (tick_stats.used_us > tick_stats.used_max_us) {
+        tick_stats.used_max_us = tick_stats.used_us;
+    }
+    if (tick_stats.used_us > tick_period_us) {
+        ++tick_stats.overruns;
+    }
+}
+
+/*******************************************************************************
+*   Function Name:      tick_skip
+*   Author(s):          George Cowan
+*   Definition:         discards due ticks without counting them, for when
+                        game is paused on purpose, and arms match again if
+                        pause let it pass unseen
+*******************************************************************************/
+void tick_skip(void) {
+    NVIC_DisableIRQ(TIMER0_IRQn);
+    tick_arm(LPC_TIM0->MR0 - tick_period_us);
+    NVIC_EnableIRQ(TIMER0_IRQn);
+
+    tick_taken = tick_raised;
+    os_evt_clr(TICK_EVENT, tick_task);
+}
+
+/*******************************************************************************
+*   Function Name:      tick_mut_wait
+*   Author(s):          George Cowan
+*   Definition:         waits on mutex like os_mut_wait, counting ticks that
+                        fall due meanwhile
+*   Parameters:         mutex, timeout in RTX ticks
+*   Returns:            result of os_mut_wait
+*******************************************************************************/
+OS_RESULT tick_mut_wait(OS_ID mutex, uint16_t timeout) {
+    uint32_t before = tick_raised;
+    OS_RESULT result = os_mut_wait(mutex, timeout);
+
+    tick_stats.lock_missed += tick_raised - before;
+    return result;
+}
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
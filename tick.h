@@ -0,0 +1,46 @@
+/*----------------------------------------------------------------------------
+* Filename:         tick.h
+* Description:      Fixed rate game tick from TIMER0 match interrupt with
+*                   budget accounting for pong on Keil MCB1700 board
+* Author(s):        George Cowan, Alexander Rathke
+* Date Modified:    Oct. 16, 2026
+*----------------------------------------------------------------------------*/
+#ifndef _TICK_H
+#define _TICK_H
+
+// event flag set on ticked task
+#define TICK_EVENT              0x0001
+// most ticks stepped at once to catch up, the rest are dropped
+#define TICK_MAX_CATCHUP        4
+
+typedef struct {
+    /*
+    tick accounting since tick_start, times are in
+    microseconds from when the tick fell due
+    */
+    uint32_t raised;
+    // ticks stepped after a later tick was already due
+    uint32_t late;
+    // ticks skipped past TICK_MAX_CATCHUP
+    uint32_t dropped;
+    // ticks that fell due while waiting on a lock
+    uint32_t lock_missed;
+    // ticks that used more than their whole budget
+    uint32_t overruns;
+    uint32_t used_us;
+    uint32_t used_max_us;
+} TickStats;
+
+extern TickStats tick_stats;
+
+void        tick_start      (OS_TID task, uint32_t period_us);
+uint8_t     tick_wait       (void);
+void        tick_done       (void);
+void        tick_skip       (void);
+OS_RESULT   tick_mut_wait   (OS_ID mutex, uint16_t timeout);
+
+#endif /* _TICK_H */
+
+/******************************************************************************
+**                            End Of File
+******************************************************************************/
@@ -29,9 +29,26 @@ volatile int ITM_RxBuffer = ITM_RXBUFFER_EMPTY;  /*  CMSIS Debug Input        */
 //#endif
 
 volatile uint32_t UART0Status, UART1Status;
+/* set while TX FIFO is drained and no THRE interrupt is coming */
 volatile uint8_t UART0TxEmpty = 1, UART1TxEmpty = 1;
-volatile uint8_t UART0Buffer[BUFSIZE], UART1Buffer[BUFSIZE];
-volatile uint32_t UART0Count = 0, UART1Count = 0;
+
+/* TX rings, single producer (UARTSend) and single consumer (THRE
+   interrupt), head is only written by UARTSend and tail only by
+   UARTTxFill, both count up freely and are taken modulo ring size */
+static uint8_t UART0TxRing[UART_TX_SIZE], UART1TxRing[UART_TX_SIZE];
+volatile uint32_t UART0TxHead = 0, UART0TxTail = 0;
+volatile uint32_t UART1TxHead = 0, UART1TxTail = 0;
+volatile uint32_t UARTTxDropped[2] = {0, 0};
+volatile uint32_t UARTTxOverflows[2] = {0, 0};
+
+/* RX rings, single producer (RX interrupt) and single consumer task,
+   head is only written by UARTRxDrain and tail only by UARTRxConsume */
+static uint8_t UART0RxRing[UART_RX_SIZE], UART1RxRing[UART_RX_SIZE];
+volatile uint32_t UART0RxHead = 0, UART0RxTail = 0;
+volatile uint32_t UART1RxHead = 0, UART1RxTail = 0;
+volatile uint32_t UARTRxOverruns[2] = {0, 0};
+volatile uint32_t UARTRxFraming[2] = {0, 0};
+volatile uint32_t UARTRxOverflows[2] = {0, 0};
 
 volatile uint8_t RcvLock0; 
 volatile uint8_t SndLock0; 
@@ -79,6 +96,98 @@ void FreeSnd(uint8_t portNum){
 	Free( portNum == 0? &SndLock0 : &SndLock1 );
 }
 
+/*****************************************************************************
+** Function name:		UARTTxFill
+**
+** Descriptions:		Move up to one FIFO worth of bytes from TX ring
+**						into THR. Called from THRE interrupt, and from
+**						UARTSend when transmitter is idle. Marks
+**						transmitter idle once ring is empty.
+**
+** parameters:			portNum
+** Returned value:		None
+** 
+*****************************************************************************/
+static void UARTTxFill( uint32_t portNum )
+{
+	LPC_UART_TypeDef *LPC_UART;
+	uint8_t *ring;
+	volatile uint32_t *UARTTxTail;
+	uint32_t head, tail, n;
+
+	LPC_UART = (portNum == 0 ? (LPC_UART_TypeDef *)LPC_UART0 : (LPC_UART_TypeDef *)LPC_UART1 );
+	ring = (portNum == 0 ? UART0TxRing : UART1TxRing);
+	UARTTxTail = (portNum == 0 ? &UART0TxTail : &UART1TxTail);
+	head = (portNum == 0 ? UART0TxHead : UART1TxHead);
+	tail = *UARTTxTail;
+
+	/* THRE means FIFO is empty, so a whole FIFO can be loaded */
+	for ( n = 0; tail != head && n < UART_TX_FIFO; n++ ){
+		LPC_UART->THR = ring[tail % UART_TX_SIZE];
+		tail++;
+	}
+	*UARTTxTail = tail;
+
+	if ( portNum == 0 )
+		UART0TxEmpty = (n == 0);
+	else
+		UART1TxEmpty = (n == 0);
+}
+
+
+/*****************************************************************************
+** Function name:		UARTRxDrain
+**
+** Descriptions:		Move every byte in RX FIFO onto RX ring. Called
+**						from RX interrupts (data available, character
+**						timeout and line status). Error bits in LSR
+**						belong to byte at top of FIFO, so bytes with
+**						framing, parity or break errors are dropped.
+**
+** parameters:			portNum, LSR read by interrupt handler
+** Returned value:		None
+** 
+*****************************************************************************/
+static void UARTRxDrain( uint32_t portNum, uint8_t LSRValue )
+{
+	LPC_UART_TypeDef *LPC_UART;
+	uint8_t *ring;
+	volatile uint32_t *UARTRxHead;
+	uint32_t head, tail;
+	uint8_t data;
+
+	LPC_UART = (portNum == 0 ? (LPC_UART_TypeDef *)LPC_UART0 : (LPC_UART_TypeDef *)LPC_UART1 );
+	ring = (portNum == 0 ? UART0RxRing : UART1RxRing);
+	UARTRxHead = (portNum == 0 ? &UART0RxHead : &UART1RxHead);
+	head = *UARTRxHead;
+	tail = (portNum == 0 ? UART0RxTail : UART1RxTail);
+
+	for (;;){
+		/* reading LSR clears OE, so it is counted on every read */
+		if ( LSRValue & LSR_OE )
+			UARTRxOverruns[portNum]++;
+		if ( !(LSRValue & LSR_RDR) )
+			break;
+
+		/* Note: read RBR will clear the interrupt */
+		data = LPC_UART->RBR;
+		if ( LSRValue & (LSR_FE | LSR_PE | LSR_BI) ){
+			UARTRxFraming[portNum]++;
+		}
+		else if ( head - tail == UART_RX_SIZE ){
+			UARTRxOverflows[portNum]++;
+		}
+		else{
+			ring[head % UART_RX_SIZE] = data;
+			head++;
+		}
+
+		LSRValue = LPC_UART->LSR;
+	}
+
+	/* publish only once bytes are in ring */
+	*UARTRxHead = head;
+}
 
 /*****************************************************************************
 ** Function name:		UART0_IRQHandler
@@ -100,29 +209,14 @@ void UART0_IRQHandler (void)
 
 	LSRValue = LPC_UART0->LSR;
 
-	if ( LSRValue & LSR_RDR )	/* Receive Data Ready */	
-	{
-		/* If no error on RLS, normal ready, save into the data buffer. */
-		/* Note: read RBR will clear the interrupt */
-		UART0Buffer[UART0Count] = LPC_UART0->RBR;
-		UART0Count++;
-		if ( UART0Count == BUFSIZE )
-		{
-		UART0Count = 0;		/* buffer overflow */
-		}
-	}
+	/* line status, data available and character timeout all empty RX
+	   FIFO, other interrupts too as reading LSR cleared any errors */
+	UARTRxDrain(0, LSRValue);
 
 	if ( IIRValue == IIR_THRE )	/* THRE, transmit holding register empty */
 	{
-	/* THRE interrupt */
-		LSRValue = LPC_UART0->LSR;		/* Check status in the LSR to see if
-									valid data in U0THR or not */
-		if ( LSRValue & LSR_THRE ){
-			UART0TxEmpty = 1;
-		}
-		else{
-			UART0TxEmpty = 0;
-		}
+	/* THRE interrupt, refill FIFO from TX ring */
+		UARTTxFill(0);
 	}
 
 }
@@ -148,28 +242,14 @@ void UART1_IRQHandler (void)
 
 	LSRValue = LPC_UART1->LSR;
 
-	if ( LSRValue & LSR_RDR )	/* Receive Data Ready */	
-	{
-		/* If no error on RLS, normal ready, save into the data buffer. */
-		/* Note: read RBR will clear the interrupt */
-		UART1Buffer[UART1Count] = LPC_UART1->RBR;
-		UART1Count++;
-		if ( UART1Count == BUFSIZE ){
-		UART0Count = 0;		/* buffer overflow */
-		}
-	}
+	/* line status, data available and character timeout all empty RX
+	   FIFO, other interrupts too as reading LSR cleared any errors */
+	UARTRxDrain(1, LSRValue);
 
 	if ( IIRValue == IIR_THRE )	/* THRE, transmit holding register empty */
 	{
-	/* THRE interrupt */
-		LSRValue = LPC_UART1->LSR;		/* Check status in the LSR to see if
-									valid data in U0THR or not */
-		if ( LSRValue & LSR_THRE ){
-			UART1TxEmpty = 1;
-		}
-		else{
-			UART1TxEmpty = 0;
-		}
+	/* THRE interrupt, refill FIFO from TX ring */
+		UARTTxFill(1);
 	}
 
 }
@@ -232,7 +312,13 @@ uint32_t UARTInit( uint32_t PortNum, uint32_t baudrate )
 		LPC_UART0->DLL = Fdiv % 256;
 
 		LPC_UART0->LCR = 0x03;		/* DLAB = 0 */
-		LPC_UART0->FCR = 0x07;		/* Enable and reset TX and RX FIFO. */
+		LPC_UART0->FCR = 0x87;		/* Enable and reset TX and RX FIFO, RX interrupt
+									at 8 bytes, timeout interrupt takes the rest */
+
+		/* interrupts stay enabled, RX and TX rings are filled and
+		   drained by interrupt */
+		UART0TxEmpty = 1;
+		LPC_UART0->IER |= IER_RBR | IER_THRE | IER_RLS;
 
 	 	NVIC_EnableIRQ(UART0_IRQn);
 
@@ -260,7 +346,13 @@ uint32_t UARTInit( uint32_t PortNum, uint32_t baudrate )
 		LPC_UART1->DLL = Fdiv % 256;
 
 		LPC_UART1->LCR = 0x03;		/* DLAB = 0 */
-		LPC_UART1->FCR = 0x07;		/* Enable and reset TX and RX FIFO. */
+		LPC_UART1->FCR = 0x87;		/* Enable and reset TX and RX FIFO, RX interrupt
+									at 8 bytes, timeout interrupt takes the rest */
+
+		/* interrupts stay enabled, RX and TX rings are filled and
+		   drained by interrupt */
+		UART1TxEmpty = 1;
+		LPC_UART1->IER |= IER_RBR | IER_THRE | IER_RLS;
 
 	 	NVIC_EnableIRQ(UART1_IRQn);
 
@@ -277,58 +369,99 @@ uint32_t UARTInit( uint32_t PortNum, uint32_t baudrate )
 /*****************************************************************************
 ** Function name:		UARTSend
 **
-** Descriptions:		Send a block of data to the UART 0 port based
-**						on the data length
+** Descriptions:		Queue a block of data on the TX ring of UART 0-1
+**						port and return at once, THRE interrupt sends it.
+**						Block is queued whole or not at all so binary
+**						streams are never cut, a block that does not fit
+**						is dropped and counted. One task per port only.
 **
 ** parameters:			portNum, buffer pointer, and data length
-** Returned value:		None
+** Returned value:		number of bytes queued, 0 if dropped
 ** 
 *****************************************************************************/
 
-void UARTSend( uint32_t portNum, uint8_t *BufferPtr, uint32_t Length )
+uint32_t UARTSend( uint32_t portNum, uint8_t *BufferPtr, uint32_t Length )
 {
 	LPC_UART_TypeDef *LPC_UART;
-	volatile unsigned char *UARTTxEmpty;				//ASK Douglas
-	uint8_t *localBufferPtr;
-	uint32_t localLength;
+	volatile unsigned char *UARTTxEmpty;
+	volatile uint32_t *UARTTxHead;
+	uint8_t *ring;
+	uint32_t head, tail, i;
 
 	if((portNum >> 1 ) != 0)
-		return;
+		return 0;
 
-	localLength = Length;
-	localBufferPtr = BufferPtr;
 	UARTTxEmpty = (portNum == 0 ? &UART0TxEmpty : &UART1TxEmpty);
+	UARTTxHead = (portNum == 0 ? &UART0TxHead : &UART1TxHead);
+	ring = (portNum == 0 ? UART0TxRing : UART1TxRing);
 	LPC_UART = (portNum == 0 ? (LPC_UART_TypeDef *)LPC_UART0 : (LPC_UART_TypeDef *)LPC_UART1 );
 
-	//Enable interupt
-	LPC_UART->IER |=  IER_THRE;
+	head = *UARTTxHead;
+	tail = (portNum == 0 ? UART0TxTail : UART1TxTail);
 
-	while( LockSnd(portNum));
+	if ( Length > UART_TX_SIZE - (head - tail) ){
+		UARTTxDropped[portNum] += Length;
+		UARTTxOverflows[portNum]++;
+		return 0;
+	}
 
-	while ( localLength != 0 ){
-		/* THRE status, contain valid data */
-		while ( !(*UARTTxEmpty & 0x01) );
-		LPC_UART->THR = *localBufferPtr;
-		*UARTTxEmpty = 0;	/* not empty in the THR until it shifts out */
-		localBufferPtr++;
-		localLength--;
+	for ( i = 0; i < Length; i++ ){
+		ring[(head + i) % UART_TX_SIZE] = BufferPtr[i];
+	}
+	/* publish only once bytes are in ring */
+	*UARTTxHead = head + Length;
+
+	/* idle transmitter raises no THRE, so first FIFO load is done here,
+	   with THRE masked so interrupt cannot load at same time */
+	if ( *UARTTxEmpty ){
+		LPC_UART->IER &= ~IER_THRE;
+		UARTTxFill(portNum);
+		LPC_UART->IER |= IER_THRE;
 	}
 
-	FreeSnd(portNum);
+	return Length;
+}
 
-	//Reanble other interpts
-	LPC_UART->IER &= ~IER_THRE;
+/*****************************************************************************
+** Function name:		UARTTxFree
+**
+** Descriptions:		Space left on TX ring of UART 0-1 port
+**
+** parameters:			portNum
+** Returned value:		bytes UARTSend can queue without dropping
+** 
+*****************************************************************************/
+uint32_t UARTTxFree( uint32_t portNum )
+{
+	if((portNum >> 1 ) != 0)
+		return 0;
 
-	return;
+	if ( portNum == 0 )
+		return UART_TX_SIZE - (UART0TxHead - UART0TxTail);
+	return UART_TX_SIZE - (UART1TxHead - UART1TxTail);
 }
 
+/*****************************************************************************
+** Function name:		UARTSendChar
+**
+** Descriptions:		Queue one character on TX ring of UART 0-1 port
+**						as UARTSend does, THRE interrupt sends it. Waits
+**						for room rather than dropping it, so console
+**						output is never cut. Counts as UARTSend producer,
+**						so only from task that sends on the port.
+**
+** parameters:			portNum, character
+** Returned value:		None
+** 
+*****************************************************************************/
 void UARTSendChar( uint32_t portNum, uint8_t character)
 {
 	#ifdef __RTGT_UART
-		LPC_UART_TypeDef *LPC_UART;
-		LPC_UART = (portNum == 0 ? (LPC_UART_TypeDef *)LPC_UART0 : (LPC_UART_TypeDef *)LPC_UART1 );
-		while (!(LPC_UART->LSR & 0x20));
-		LPC_UART->THR = character;
+		if((portNum >> 1 ) != 0)
+			return;
+
+		while ( UARTTxFree(portNum) == 0 );
+		UARTSend(portNum, &character, 1);
 	#else
 		ITM_SendChar(character);
 	#endif
@@ -339,69 +472,120 @@ void UARTSendChar( uint32_t portNum, uint8_t character)
 /*****************************************************************************
 ** Function name:		UARTRecieve
 **
-** Descriptions:		Recieve a block of data to the UART 0-1 port based
-**						on the data length
+** Descriptions:		Recieve a block of data from the UART 0-1 port,
+**						waits for at least one byte then copies out as
+**						many as are on RX ring, up to the data length
 **
 ** parameters:			portNum, buffer pointer, and data length
-** Returned value:		integer showing status
+** Returned value:		number of bytes copied
 ** 
 *****************************************************************************/
 uint32_t UARTRecieve( uint32_t portNum, uint8_t *BufferPtr, uint32_t Length )
 {
-
-	LPC_UART_TypeDef *LPC_UART;
-	volatile uint32_t *UARTCount;				//ASK Douglas
-	volatile uint8_t *UARTBuffer;
-	uint8_t *rcvdBufferPtr;
-	uint32_t rcvd_len, i;
+	uint8_t *data;
+	uint32_t rcvd_len, n, i;
 
 	if((portNum >> 1 ) != 0)
 		return 0;
 
-	rcvd_len = 0x0;
-	rcvdBufferPtr = BufferPtr;
-	UARTCount = (portNum == 0 ? &UART0Count : &UART1Count);
-	UARTBuffer = (portNum == 0 ? UART0Buffer : UART1Buffer);
-	LPC_UART = (portNum == 0 ? (LPC_UART_TypeDef *)LPC_UART0 : (LPC_UART_TypeDef *)LPC_UART1 );
-
-	*UARTCount = 0x0;
+	//busy waiting
+	while( UARTRxCount(portNum) == 0 );
 
-	//Enable interupt
-	LPC_UART->IER |=  IER_RBR;
+	rcvd_len = 0x0;
+	while ( rcvd_len < Length && (n = UARTRxPeek(portNum, &data)) != 0 ){
+		if ( n > Length - rcvd_len )
+			n = Length - rcvd_len;
+		for ( i = 0; i < n; ++i )
+			BufferPtr[rcvd_len++] = data[i];
+		UARTRxConsume(portNum, n);
+	}
 
-	//busy waiting
+	return rcvd_len;
+}
 
-	while( *UARTCount == 0 );
+/*****************************************************************************
+** Function name:		UARTRxCount
+**
+** Descriptions:		Bytes waiting on RX ring of UART 0-1 port
+**
+** parameters:			portNum
+** Returned value:		number of bytes received and not yet consumed
+** 
+*****************************************************************************/
+uint32_t UARTRxCount( uint32_t portNum )
+{
+	if((portNum >> 1 ) != 0)
+		return 0;
 
+	if ( portNum == 0 )
+		return UART0RxHead - UART0RxTail;
+	return UART1RxHead - UART1RxTail;
+}
 
-	//This part has to be put in the critical section
-	while(LockRcv(portNum));
+/*****************************************************************************
+** Function name:		UARTRxPeek
+**
+** Descriptions:		Hands out oldest received bytes in place, without
+**						copying. Slice stops where ring wraps, so a second
+**						peek after consuming may return more. Bytes stay
+**						valid until consumed. One task per port only.
+**
+** parameters:			portNum, set to first byte of slice
+** Returned value:		length of slice, 0 if nothing received
+** 
+*****************************************************************************/
+uint32_t UARTRxPeek( uint32_t portNum, uint8_t **DataPtr )
+{
+	uint8_t *ring;
+	uint32_t head, tail, n;
 
-	//Reanble other interpts
-	LPC_UART->IER &= ~IER_RBR;			/* Disable RBR */
+	if((portNum >> 1 ) != 0)
+		return 0;
 
+	ring = (portNum == 0 ? UART0RxRing : UART1RxRing);
+	head = (portNum == 0 ? UART0RxHead : UART1RxHead);
+	tail = (portNum == 0 ? UART0RxTail : UART1RxTail);
 
-	for(i = 0; i < *UARTCount; ++i)
-		rcvdBufferPtr[rcvd_len++] = UARTBuffer[i];
+	n = head - tail;
+	if ( n > UART_RX_SIZE - (tail % UART_RX_SIZE) )
+		n = UART_RX_SIZE - (tail % UART_RX_SIZE);
 
-	*UARTCount = 0;
+	*DataPtr = &ring[tail % UART_RX_SIZE];
+	return n;
+}
 
-	FreeRcv(portNum);
+/*****************************************************************************
+** Function name:		UARTRxConsume
+**
+** Descriptions:		Releases bytes handed out by UARTRxPeek back to
+**						RX interrupt
+**
+** parameters:			portNum, bytes to release, at most length of
+**						last peek
+** Returned value:		None
+** 
+*****************************************************************************/
+void UARTRxConsume( uint32_t portNum, uint32_t Length )
+{
+	if((portNum >> 1 ) != 0)
+		return;
 
-	return rcvd_len;
+	if ( portNum == 0 )
+		UART0RxTail += Length;
+	else
+		UART1RxTail += Length;
 }
 
 uint8_t UARTReceiveChar( uint32_t portNum)
 {
 	#ifdef __RTGT_UART
-		/*uint8_t ret[1];
-		if (UARTRecieve(portNum, ret, 1) == 1)
-			return ret[0];
-		return 0x0;	*/
-		LPC_UART_TypeDef *LPC_UART;
-		LPC_UART = (portNum == 0 ? (LPC_UART_TypeDef *)LPC_UART0 : (LPC_UART_TypeDef *)LPC_UART1 );
-		while (!(LPC_UART->LSR & 0x01));
-		return (LPC_UART->RBR);
+		uint8_t *data;
+		uint8_t character;
+
+		while ( UARTRxPeek(portNum, &data) == 0 );
+		character = *data;
+		UARTRxConsume(portNum, 1);
+		return character;
 	#else
 		while (ITM_CheckChar() != 1) __NOP();
 		return (ITM_ReceiveChar());
@@ -43,6 +43,13 @@
 
 #define BUFSIZE		0x40
 
+/* TX ring per port, must be a power of two */
+#define UART_TX_SIZE	1024
+/* bytes loaded per THRE interrupt, depth of TX FIFO */
+#define UART_TX_FIFO	16
+/* RX ring per port, must be a power of two */
+#define UART_RX_SIZE	256
+
 #ifndef FALSE
 #define FALSE   (0)
 #endif
@@ -51,14 +58,26 @@
 #define TRUE    (1)
 #endif
 
+/* bytes dropped because TX ring was full, and sends they came from */
+extern volatile uint32_t UARTTxDropped[2];
+extern volatile uint32_t UARTTxOverflows[2];
+/* bytes lost by RX FIFO (OE), bytes dropped with framing, parity or
+   break errors, and good bytes dropped because RX ring was full */
+extern volatile uint32_t UARTRxOverruns[2];
+extern volatile uint32_t UARTRxFraming[2];
+extern volatile uint32_t UARTRxOverflows[2];
 
 void UART0_IRQHandler( void );
 void UART1_IRQHandler( void );
 
 uint32_t UARTInit( uint32_t portNum, uint32_t Baudrate );
 
-void     UARTSend(    uint32_t portNum, uint8_t *BufferPtr, uint32_t Length );
+uint32_t UARTSend(    uint32_t portNum, uint8_t *BufferPtr, uint32_t Length );
+uint32_t UARTTxFree(  uint32_t portNum );
 uint32_t UARTRecieve( uint32_t portNum, uint8_t *BufferPtr, uint32_t Length );
+uint32_t UARTRxCount( uint32_t portNum );
+uint32_t UARTRxPeek(  uint32_t portNum, uint8_t **DataPtr );
+void     UARTRxConsume( uint32_t portNum, uint32_t Length );
 
 void     UARTSendChar(    uint32_t portNum, uint8_t character );
 uint8_t  UARTReceiveChar( uint32_t portNum );
@@ -2,9 +2,9 @@
 * Filename:         utils.c
 * Description:      Utility functions for pong game on Keil MCB1700 board
 * Author(s):        George Cowan, Alexander Rathke
-* Date Modified:    Nov. 13, 2017
+* Date Modified:    Oct. 16, 2026
 *----------------------------------------------------------------------------*/
-#include <lpc17xx.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include "utils.h"
 